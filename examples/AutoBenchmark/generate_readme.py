@@ -224,6 +224,28 @@ number of `TimingStats::update()` calls that were made.
     * The majority of the time is spent on the `bitDelay()` between bit
       transitions in the protocol.
 
+**Unreleased**
+
+The results below were collected before the following changes, and have not
+been regenerated, because that requires the target boards. They must be
+regenerated by running `make README.md` with fresh `*.txt` files before the
+next release.
+
+* Embed the `LedMatrix` inside `DirectModule`, `DirectFast4Module`,
+  `HybridModule` and `Hc595Module`, instead of holding a reference to it.
+  `renderFieldNow()` no longer loads the reference, and the `sizeof()` of
+  these modules should shrink by one pointer, but the tables still show the
+  old values.
+* Move the mode-specific state of `ScanningModule` into empty base classes, and
+  pack the per-digit brightness. The `sizeof()` values of the scanning modules
+  are out of date, and `renderFieldNow()` now unpacks the brightness of each
+  digit when `T_SUBFIELDS > 1` and the maximum brightness is at most 15, which
+  has not been timed.
+* Move the flush logic of `Tm1637Module` and `Max7219Module` into
+  `Tm1637ModuleBase` and `Max7219ModuleBase`, which loop over the runtime
+  number of digits instead of `T_DIGITS`. The `flush()` and
+  `flushIncremental()` times of these modules have not been measured since.
+
 ## Results
 
 The following tables show the number of microseconds taken by:
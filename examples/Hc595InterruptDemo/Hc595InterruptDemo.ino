@@ -33,12 +33,12 @@
 #include <TimerOne.h> // Timer1
 
 using ace_common::incrementMod;
-using ace_common::incrementModOffset;
-using ace_common::TimingStats;
 using ace_spi::HardSpiInterface;
 using ace_spi::SimpleSpiInterface;
 using ace_segment::LedModule;
 using ace_segment::Hc595Module;
+using ace_segment::ScanningTimer;
+using ace_segment::TimerIsr;
 using ace_segment::kDigitRemapArray8Hc595;
 using ace_segment::kByteOrderDigitHighSegmentLow;
 using ace_segment::kByteOrderSegmentHighDigitLow;
@@ -252,7 +252,6 @@ void setupAceSegment() {
 
 //----------------------------------------------------------------------------
 
-TimingStats stats;
 uint8_t digitIndex = 0;
 uint8_t brightnessIndex = 0;
 
@@ -281,51 +280,39 @@ void updateDisplay() {
   }
 }
 
-// Call renderFieldNow() through a timer interrupt.
-void flushModule() {
-  ledModule.renderFieldNow();
-}
+// Implementation of the TimerInterface using the TimerOne library.
+class TimerOneInterface {
+  public:
+    static void begin(uint32_t periodMicros, TimerIsr isr) {
+      Timer1.initialize(periodMicros);
+      Timer1.attachInterrupt(isr);
+    }
 
-void setupTimer() {
-  Timer1.initialize(ledModule.getMicrosPerField());
-  Timer1.attachInterrupt(flushModule);
-}
+    static void setPeriod(uint32_t periodMicros) {
+      Timer1.setPeriod(periodMicros);
+    }
 
-// Every 5 seconds, print stats about how long flushModule() took.
-void printStats() {
-#if ENABLE_SERIAL_DEBUG >= 1
-  static uint16_t prevStatsMillis;
+    static void end() {
+      Timer1.detachInterrupt();
+      Timer1.stop();
+    }
+};
 
-  uint16_t nowMillis = millis();
-  if ((uint16_t) (nowMillis - prevStatsMillis) >= 5000) {
-    prevStatsMillis = nowMillis;
-
-    Serial.print("min/avg/max:");
-    Serial.print(stats.getMin());
-    Serial.print('/');
-    Serial.print(stats.getAvg());
-    Serial.print('/');
-    Serial.println(stats.getMax());
-    stats.reset();
-  }
-#endif
+// Call renderFieldNow() through a timer interrupt.
+ScanningTimer<decltype(ledModule), TimerOneInterface> scanningTimer(ledModule);
+
+void setupTimer() {
+  scanningTimer.begin();
 }
 
 //----------------------------------------------------------------------------
 
 void setup() {
   delay(1000);
-
-#if ENABLE_SERIAL_DEBUG >= 1
-  Serial.begin(115200);
-  while (!Serial);
-#endif
-
   setupAceSegment();
   setupTimer();
 }
 
 void loop() {
   updateDisplay();
-  printStats();
 }
@@ -39,6 +39,8 @@
 #define FEATURE_HT16K33_TWO_WIRE 21
 #define FEATURE_HT16K33_SIMPLE_WIRE 22
 #define FEATURE_HT16K33_SIMPLE_WIRE_FAST 23
+#define FEATURE_TM1637_TMI_MULTI 24
+#define FEATURE_MAX7219_HARD_SPI_MULTI 25
 
 // A volatile integer to prevent the compiler from optimizing away the entire
 // program.
@@ -328,6 +330,27 @@ volatile int disableCompilerOptimization = 0;
     Ht16k33Module<WireInterface, NUM_DIGITS> ht16k33Module(
         wireInterface, HT16K33_I2C_ADDRESS);
 
+  #elif FEATURE == FEATURE_TM1637_TMI_MULTI
+    // Two modules with different number of digits on the same interface type.
+    // The flash delta relative to FEATURE_TM1637_TMI is the cost of the second
+    // module.
+    using TmiInterface = SimpleTmi1637Interface;
+    TmiInterface tmiInterface(DIO_PIN, CLK_PIN, BIT_DELAY);
+    Tm1637Module<TmiInterface, NUM_DIGITS> tm1637Module(tmiInterface);
+    Tm1637Module<TmiInterface, 6> tm1637Module6(
+        tmiInterface, kDigitRemapArray6Tm1637);
+
+  #elif FEATURE == FEATURE_MAX7219_HARD_SPI_MULTI
+    // Two modules with different number of digits on the same interface type.
+    // The flash delta relative to FEATURE_MAX7219_HARD_SPI is the cost of the
+    // second module.
+    using SpiInterface = HardSpiInterface<SPIClass>;
+    SpiInterface spiInterface(SPI, LATCH_PIN);
+    Max7219Module<SpiInterface, NUM_DIGITS> max7219Module(
+        spiInterface, kDigitRemapArray8Max7219);
+    Max7219Module<SpiInterface, 8> max7219Module8(
+        spiInterface, kDigitRemapArray8Max7219);
+
   #else
     #error Unknown FEATURE
 
@@ -463,6 +486,17 @@ void setup() {
   wireInterface.begin();
   ht16k33Module.begin();
 
+#elif FEATURE == FEATURE_TM1637_TMI_MULTI
+  tmiInterface.begin();
+  tm1637Module.begin();
+  tm1637Module6.begin();
+
+#elif FEATURE == FEATURE_MAX7219_HARD_SPI_MULTI
+  SPI.begin();
+  spiInterface.begin();
+  max7219Module.begin();
+  max7219Module8.begin();
+
 #else
   #error Unknown FEATURE
 
@@ -533,6 +567,18 @@ void loop() {
   ht16k33Module.setPatternAt(0, 0xff);
   ht16k33Module.flush();
 
+#elif FEATURE == FEATURE_TM1637_TMI_MULTI
+  tm1637Module.setPatternAt(0, 0xff);
+  tm1637Module.flush();
+  tm1637Module6.setPatternAt(0, 0xff);
+  tm1637Module6.flush();
+
+#elif FEATURE == FEATURE_MAX7219_HARD_SPI_MULTI
+  max7219Module.setPatternAt(0, 0xff);
+  max7219Module.flush();
+  max7219Module8.setPatternAt(0, 0xff);
+  max7219Module8.flush();
+
 #elif FEATURE == FEATURE_STUB_MODULE
   stubModule.setPatternAt(0, 0xff);
 
@@ -261,6 +261,32 @@ before substantional refactoring in 2021.
 * Significant increase in flash memory usage for STM32duino (1-4 kB) and ESP32
   (4-8 kB).
 
+**Unreleased**
+
+The results below were collected before the following changes, and have not
+been regenerated, because that requires the toolchains of the target boards.
+They must be regenerated for every board, including the ATtiny85, by running
+`collect.sh` and `make README.md` before the next release.
+
+* Embed the `LedMatrix` inside `DirectModule`, `DirectFast4Module`,
+  `HybridModule` and `Hc595Module`, instead of holding a reference to it. This
+  is expected to save the static RAM of one pointer per module, but the rows of
+  these modules still show the old sizes.
+* Move the mode-specific state of `ScanningModule` (subfields, per-digit
+  brightness, segment-major patterns, scan set) into empty base classes, and
+  pack the per-digit brightness. This reduces the static RAM of every scanning
+  module that does not use those modes, but the rows of `DirectModule`,
+  `DirectFast4Module`, `HybridModule` and `Hc595Module` still show the old
+  sizes.
+* Add `Tm1637(SimpleTmi1637) x2` and `Max7219(HardSpi) x2`, which use 2
+  modules with different numbers of digits on the same interface type. The
+  digit-independent logic moved into `Tm1637ModuleBase` and
+  `Max7219ModuleBase`, so the second module should add little more than its
+  pattern array and constructor. These 2 rows have never been measured, so
+  they are missing from every table below, including the ATtiny85. The existing
+  `Tm1637` and `Max7219` rows still show the sizes before the move into the
+  base classes.
+
 ## Results
 
 The following shows the flash and static memory sizes of the `MemoryBenchmark`
@@ -30,6 +30,8 @@ BEGIN {
   labels[21] = "Ht16k33(TwoWire)";
   labels[22] = "Ht16k33(SimpleWire)";
   labels[23] = "Ht16k33(SimpleWireFast)";
+  labels[24] = "Tm1637(SimpleTmi1637) x2";
+  labels[25] = "Max7219(HardSpi) x2";
   record_index = 0
 }
 {
@@ -63,10 +65,11 @@ END {
         || name ~ /DirectModule/ \
         || name ~ /Hybrid\(HardSpi\)/ \
         || name ~ /Hc595\(HardSpi\)/ \
-        || name ~ /Tm1637\(SimpleTmi1637\)/ \
+        || name ~ /Tm1637\(SimpleTmi1637\)$/ \
         || name ~ /Tm1638\(SimpleTmi1638\)/ \
         || name ~ /Max7219\(HardSpi\)/ \
-        || name ~ /Ht16k33\(TwoWire\)/) {
+        || name ~ /Ht16k33\(TwoWire\)/ \
+        || name ~ /Tm1637\(SimpleTmi1637\) x2/) {
       printf(\
         "|---------------------------------+--------------+-------------|\n")
     }
@@ -0,0 +1,136 @@
+/*
+ * Same as HelloHc595, but instead of polling renderFieldWhenReady()
+ * continuously, the loop() sleeps until the next field is due, using
+ * getMicrosUntilNextField(). On AVR, the CPU is put into the IDLE sleep mode,
+ * which is woken by the next interrupt (the Timer0 overflow of millis() every
+ * 1024 micros at the latest), and the last fraction of a millisecond is spent
+ * in delayMicroseconds(). Every 5 seconds, the number of loop() iterations and
+ * of rendered fields is printed on the Serial port. They should be about the
+ * same.
+ */
+
+#include <Arduino.h>
+#include <SPI.h> // SPIClass, SPI
+#include <AceSPI.h> // HardSpiInterface
+#include <AceSegment.h> // Hc595Module
+#if defined(ARDUINO_ARCH_AVR)
+  #include <avr/sleep.h>
+#endif
+
+using ace_spi::HardSpiInterface;
+using ace_segment::Hc595Module;
+using ace_segment::kDigitRemapArray8Hc595;
+using ace_segment::kByteOrderSegmentHighDigitLow;
+using ace_segment::kActiveLowPattern;
+using ace_segment::kActiveHighPattern;
+
+// Replace these with the PIN numbers of your dev board.
+const uint8_t LATCH_PIN = 10;
+const uint8_t DATA_PIN = MOSI;
+const uint8_t CLOCK_PIN = SCK;
+const uint8_t NUM_DIGITS = 8;
+
+const uint8_t SEGMENT_ON_PATTERN = kActiveLowPattern;
+const uint8_t DIGIT_ON_PATTERN = kActiveHighPattern;
+const uint8_t HC595_BYTE_ORDER = kByteOrderSegmentHighDigitLow;
+const uint8_t* const REMAP_ARRAY = kDigitRemapArray8Hc595;
+const uint8_t NUM_SUBFIELDS = 1;
+const uint8_t FRAMES_PER_SECOND = 60;
+
+using SpiInterface = HardSpiInterface<SPIClass>;
+SpiInterface spiInterface(SPI, LATCH_PIN);
+Hc595Module<SpiInterface, NUM_DIGITS, NUM_SUBFIELDS> ledModule(
+    spiInterface,
+    SEGMENT_ON_PATTERN,
+    DIGIT_ON_PATTERN,
+    FRAMES_PER_SECOND,
+    HC595_BYTE_ORDER,
+    REMAP_ARRAY
+);
+
+// LED segment patterns.
+const uint8_t NUM_PATTERNS = 10;
+const uint8_t PATTERNS[NUM_PATTERNS] = {
+  0b00111111, // 0
+  0b00000110, // 1
+  0b01011011, // 2
+  0b01001111, // 3
+  0b01100110, // 4
+  0b01101101, // 5
+  0b01111101, // 6
+  0b00000111, // 7
+  0b01111111, // 8
+  0b01101111, // 9
+};
+
+//----------------------------------------------------------------------------
+
+// Sleep for the given duration. The IDLE sleep mode on AVR can overshoot by up
+// to one Timer0 overflow, so it is used only if the remaining time is longer
+// than that.
+const uint16_t SLEEP_GRANULARITY_MICROS = 1100;
+
+void sleepMicros(uint32_t durationMicros) {
+  uint32_t startMicros = micros();
+#if defined(ARDUINO_ARCH_AVR)
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  while ((uint32_t) (micros() - startMicros) + SLEEP_GRANULARITY_MICROS
+      < durationMicros) {
+    sleep_mode();
+  }
+#endif
+  uint32_t elapsedMicros = micros() - startMicros;
+  if (elapsedMicros < durationMicros) {
+    delayMicroseconds(durationMicros - elapsedMicros);
+  }
+}
+
+//----------------------------------------------------------------------------
+
+uint16_t numIterations;
+uint16_t numFields;
+
+// Every 5 seconds, print the number of loop() iterations and rendered fields.
+// Returns the number of micros until the next report.
+uint32_t printStats() {
+  static uint32_t prevStatsMillis;
+
+  uint32_t elapsedMillis = millis() - prevStatsMillis;
+  if (elapsedMillis >= 5000) {
+    prevStatsMillis += 5000;
+    elapsedMillis -= 5000;
+
+    Serial.print(F("iterations="));
+    Serial.print(numIterations);
+    Serial.print(F("; fields="));
+    Serial.println(numFields);
+    numIterations = 0;
+    numFields = 0;
+  }
+  return (5000 - elapsedMillis) * 1000;
+}
+
+void setup() {
+  delay(1000);
+  Serial.begin(115200);
+  while (!Serial); // Wait until Serial is ready - Leonardo/Micro
+
+  SPI.begin();
+  spiInterface.begin();
+  ledModule.begin();
+
+  for (uint8_t i = 0; i < NUM_DIGITS; i++) {
+    ledModule.setPatternAt(i, PATTERNS[i]);
+  }
+}
+
+void loop() {
+  numIterations++;
+  if (ledModule.renderFieldWhenReady()) numFields++;
+
+  // Sleep until the earliest deadline.
+  uint32_t sleepDuration = ledModule.getMicrosUntilNextField();
+  uint32_t statsDuration = printStats();
+  if (statsDuration < sleepDuration) sleepDuration = statsDuration;
+  sleepMicros(sleepDuration);
+}
@@ -33,6 +33,7 @@ using ace_segment::Tm1637Module;
 // Select the TM1637Module flush() method
 #define TM_FLUSH_METHOD_NORMAL 0
 #define TM_FLUSH_METHOD_INCREMENTAL 1
+#define TM_FLUSH_METHOD_BURST 2
 
 //----------------------------------------------------------------------------
 // Hardware configuration.
@@ -45,7 +46,7 @@ using ace_segment::Tm1637Module;
 
 #if defined(EPOXY_DUINO)
   #define TMI_INTERFACE_TYPE TMI_INTERFACE_TYPE_FAST
-  #define TM_FLUSH_METHOD TM_FLUSH_METHOD_INCREMENTAL
+  #define TM_FLUSH_METHOD TM_FLUSH_METHOD_BURST
 
   const uint8_t CLK_PIN = A0;
   const uint8_t DIO1_PIN = 9;
@@ -198,6 +199,24 @@ void flushModule() {
   }
 }
 
+// Every 100 ms, flushBurst() sends only the dirty digits and brightness, using
+// runs of adjacent digits, or a full flush() if that is cheaper.
+void flushBurstModule() {
+  static uint16_t prevFlushMillis;
+
+  uint16_t nowMillis = millis();
+  if ((uint16_t) (nowMillis - prevFlushMillis) >= 100) {
+    prevFlushMillis = nowMillis;
+
+    // Flush the dirty parts, and measure the time.
+    uint16_t startMicros = micros();
+    ledModule1.flushBurst();
+    ledModule2.flushBurst();
+    uint16_t elapsedMicros = (uint16_t) micros() - startMicros;
+    stats.update(elapsedMicros);
+  }
+}
+
 // Every 5 seconds, print stats about how long flush() or flushIncremental()
 // took.
 void printStats() {
@@ -240,6 +259,8 @@ void loop() {
   flushModule();
 #elif TM_FLUSH_METHOD == TM_FLUSH_METHOD_INCREMENTAL
   flushIncrementalModule();
+#elif TM_FLUSH_METHOD == TM_FLUSH_METHOD_BURST
+  flushBurstModule();
 #else
   #error Unknown TM_FLUSH_METHOD
 #endif
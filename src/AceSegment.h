@@ -48,19 +48,30 @@ SOFTWARE.
 
 #include "ace_segment/hw/ClockInterface.h"
 #include "ace_segment/hw/GpioInterface.h"
+#include "ace_segment/hw/PwmInterface.h"
+#include "ace_segment/hw/TimerInterface.h"
 #include "ace_segment/hw/remap.h"
 #include "ace_segment/scanning/LedMatrixDirect.h"
 #include "ace_segment/scanning/LedMatrixSingleHc595.h"
 #include "ace_segment/scanning/LedMatrixDualHc595.h"
+#include "ace_segment/scanning/LedMatrixDualBankHc595.h"
+#include "ace_segment/styles/Styler.h"
+#include "ace_segment/queue/UpdateQueue.h"
 #include "ace_segment/LedModule.h"
 #include "ace_segment/scanning/ScanningModule.h"
+#include "ace_segment/scanning/ScanningTimer.h"
+#include "ace_segment/scanning/ScanningScheduler.h"
+#include "ace_segment/scanning/FrameRateGovernor.h"
 #include "ace_segment/direct/DirectModule.h"
 #include "ace_segment/hybrid/HybridModule.h"
 #include "ace_segment/hc595/Hc595Module.h"
 #include "ace_segment/tm1637/Tm1637Module.h"
 #include "ace_segment/tm1638/Tm1638Module.h"
 #include "ace_segment/tm1638/Tm1638AnodeModule.h"
+#include "ace_segment/tm1638/Tm1638ExtendedModule.h"
 #include "ace_segment/max7219/Max7219Module.h"
 #include "ace_segment/ht16k33/Ht16k33Module.h"
+#include "ace_segment/buttons/ButtonDebouncer.h"
+#include "ace_segment/buttons/ButtonScanner.h"
 
 #endif
@@ -26,9 +26,27 @@ SOFTWARE.
 #define ACE_SEGMENT_LED_MODULE_H
 
 #include <stdint.h>
+#include <string.h> // memset()
+#include "styles/Styler.h"
+
+/**
+ * Set to 1 before including AceSegment.h to enable LedModule::setStyler().
+ * Disabled by default, so that the modules which do not use a Styler do not
+ * carry its pointer, and do not read the clock on every flush.
+ */
+#if ! defined(ACE_SEGMENT_ENABLE_STYLER)
+  #define ACE_SEGMENT_ENABLE_STYLER 0
+#endif
 
 namespace ace_segment {
 
+/**
+ * Returned by the deadline methods (e.g.
+ * Tm1637Module::getMicrosUntilNextFlush()) when the module has nothing to do
+ * until one of its patterns or its brightness is changed.
+ */
+static const uint32_t kMicrosNoDeadline = UINT32_MAX;
+
 /**
  * General interface that represents a generic seven-segment LED module with
  * multiple digits. Subclasses will support different driver chips (e.g. TM1637,
@@ -104,13 +122,62 @@ class LedModule {
       }
     }
 
+  #if ACE_SEGMENT_ENABLE_STYLER
+    /**
+     * Attach a Styler which applies frame-level effects (e.g. blinking) to the
+     * digits without rewriting their patterns. Pass nullptr to detach. The
+     * Styler must be initialized separately using Styler::begin(). Available
+     * only if ACE_SEGMENT_ENABLE_STYLER is 1.
+     */
+    void setStyler(Styler* styler) {
+      mStyler = styler;
+      mDigitDirtyBits = (uint8_t) ((1U << mNumDigits) - 1);
+    }
+  #endif
+
+    /**
+     * Return the attached Styler, or nullptr. Always nullptr if
+     * ACE_SEGMENT_ENABLE_STYLER is 0.
+     */
+    Styler* getStyler() const {
+    #if ACE_SEGMENT_ENABLE_STYLER
+      return mStyler;
+    #else
+      return nullptr;
+    #endif
+    }
+
+    /**
+     * Evaluate the styles of the attached Styler at `nowMillis`, and mark the
+     * digits whose styled pattern changed as dirty. Does nothing if no Styler
+     * is attached.
+     *
+     * The flush methods of the controller modules call this automatically,
+     * but isFlushRequired() does not. A loop() which calls flush() only when
+     * isFlushRequired() is true must call this first, otherwise the styles
+     * never take effect. The ScanningModule calls this at the start of every
+     * frame, so it must not be called separately for a ScanningModule.
+     */
+    void updateStyler(uint32_t nowMillis) {
+    #if ACE_SEGMENT_ENABLE_STYLER
+      if (mStyler) {
+        mDigitDirtyBits |= mStyler->update(nowMillis)
+            & (uint8_t) ((1U << mNumDigits) - 1);
+      }
+    #else
+      (void) nowMillis;
+    #endif
+    }
+
   protected:
     /** Subclasses should call this from its own begin(). */
     void begin() {
       // Dirty bits are set to true so that the first refresh sends the current
       // pattern to the LED module. Otherwise, nothing will be displayed until
-      // a setPatternAt() or setBrightness() is called.
-      mDigitDirtyBits = 0xFF;
+      // a setPatternAt() or setBrightness() is called. Only the bits of valid
+      // digits are set, otherwise isAnyDigitDirty() would stay true forever
+      // on modules with fewer than 8 digits.
+      mDigitDirtyBits = (uint8_t) ((1U << mNumDigits) - 1);
       mIsBrightnessDirty = true;
 
       // On some LEDs, level 0 turns off the display, but on others level 0 is
@@ -123,6 +190,35 @@ class LedModule {
      */
     void end() {}
 
+    /** Set the patterns of all digits to 0, without marking them dirty. */
+    void clearPatterns() {
+      memset(mPatterns, 0, mNumDigits);
+    }
+
+    /** Return the pattern at pos after applying the style of the digit. */
+    uint8_t getStyledPatternAt(uint8_t pos) const {
+      const Styler* styler = getStyler();
+      return styler
+          ? styler->applyPattern(pos, mPatterns[pos])
+          : mPatterns[pos];
+    }
+
+    /** Return the brightness of digit pos after applying its style. */
+    uint8_t getStyledBrightnessAt(uint8_t pos, uint8_t brightness) const {
+      const Styler* styler = getStyler();
+      return styler
+          ? styler->applyBrightness(pos, brightness)
+          : brightness;
+    }
+
+    /** Return true if the styled patterns of all digits are 0. */
+    bool isBlank() const {
+      for (uint8_t pos = 0; pos < mNumDigits; ++pos) {
+        if (getStyledPatternAt(pos) != 0) return false;
+      }
+      return true;
+    }
+
     /** Set the dirty bit of digit `pos`. */
     void setDigitDirty(uint8_t pos) {
       mDigitDirtyBits |= (1 << pos);
@@ -143,6 +239,11 @@ class LedModule {
       mDigitDirtyBits = 0x0;
     }
 
+    /** Return the dirty bits of all digits, bit N for digit N. */
+    uint8_t getDigitDirtyBits() const {
+      return mDigitDirtyBits;
+    }
+
     /** Return true if any digits are dirty. */
     bool isAnyDigitDirty() const {
       return mDigitDirtyBits != 0;
@@ -172,6 +273,9 @@ class LedModule {
     // The order of these instance variables is partially motivated to save
     // memory on 32-bit processors.
     uint8_t* const mPatterns;
+  #if ACE_SEGMENT_ENABLE_STYLER
+    Styler* mStyler = nullptr;
+  #endif
     uint8_t const mNumDigits;
 
     uint8_t mDigitDirtyBits; // array of 8 dirty bits
@@ -179,6 +283,59 @@ class LedModule {
     bool mIsBrightnessDirty;
 };
 
+/**
+ * Automatic power-down of the display while it is dark, i.e. all of its digits
+ * are blank. Inherited by the modules which support it (ScanningModule,
+ * Max7219Module, Ht16k33Module), instead of being part of LedModule, so that
+ * the other modules do not carry its state.
+ */
+class AutoPowerDown {
+  public:
+    /**
+     * Enable the automatic power-down of the display while it is dark. The
+     * ScanningModule stops drawing, and Max7219Module and Ht16k33Module put
+     * their chip into standby. The display resumes at the first
+     * renderFieldNow() or flush() after a digit becomes non-blank, so these
+     * must still be called while powered down: a timer which calls
+     * renderFieldNow() keeps firing. Disabled by default.
+     */
+    void setAutoPowerDown(bool enable) {
+      mIsAutoPowerDown = enable;
+    }
+
+    /** Return true if the automatic power-down is enabled. */
+    bool isAutoPowerDown() const { return mIsAutoPowerDown; }
+
+    /** Return true if the display is currently powered down. */
+    bool isPoweredDown() const { return mIsPoweredDown; }
+
+  protected:
+    /** Subclasses should call this from its own begin(). */
+    void beginPowerDown() {
+      mIsPoweredDown = false;
+    }
+
+    /**
+     * Update the power-down state, given whether the display is dark and the
+     * automatic power-down is enabled. The caller should pass
+     * `isAutoPowerDown() && isDark()`, so that the digits are not checked
+     * when it is disabled. Return true if the state changed, in which case the
+     * subclass must power its hardware down or up according to
+     * isPoweredDown().
+     */
+    bool updatePowerDown(bool isDark) {
+      const bool powerDown = mIsAutoPowerDown && isDark;
+      if (powerDown == mIsPoweredDown) return false;
+
+      mIsPoweredDown = powerDown;
+      return true;
+    }
+
+  private:
+    bool mIsAutoPowerDown = false;
+    bool mIsPoweredDown = false;
+};
+
 } // ace_segment
 
 #endif
@@ -0,0 +1,190 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_BUTTON_DEBOUNCER_H
+#define ACE_SEGMENT_BUTTON_DEBOUNCER_H
+
+#include <stdint.h>
+#include <AceCommon.h> // incrementMod()
+
+namespace ace_segment {
+
+/** Event type for a button which became pressed. */
+const uint8_t kButtonEventPressed = 0;
+
+/** Event type for a button which became released. */
+const uint8_t kButtonEventReleased = 1;
+
+/** Event type for a button which has been held down for a long time. */
+const uint8_t kButtonEventLongPressed = 2;
+
+/** An event generated by the ButtonDebouncer. */
+struct ButtonEvent {
+  /** One of the kButtonEventXxx constants. */
+  uint8_t type;
+
+  /** The bit position [0, 31] of the button in the raw bit mask. */
+  uint8_t button;
+};
+
+/**
+ * A debouncer for up to 32 buttons which processes all of the buttons in
+ * parallel using a 2-bit vertical counter per button. The raw state of all
+ * buttons is passed into update() as a bit mask (1 meaning pressed) at a
+ * regular interval, for example every 5 ms. A button changes its debounced
+ * state only after 4 consecutive samples agree, so the debouncing time is 4
+ * times the sampling interval. The cost of each update() is a handful of
+ * bitwise operations, independent of the number of buttons.
+ *
+ * Changes in the debounced state are converted into kButtonEventPressed and
+ * kButtonEventReleased events. A kButtonEventLongPressed event is generated
+ * once for each button which is still held down after the set of pressed
+ * buttons has not changed for longPressMillis. The events are stored in a
+ * small ring buffer of T_QUEUE_SIZE events, and retrieved using readEvent().
+ * If the ring buffer is full, new events are dropped.
+ *
+ * @tparam T_QUEUE_SIZE size of the event ring buffer (default 8)
+ */
+template <uint8_t T_QUEUE_SIZE = 8>
+class ButtonDebouncer {
+  public:
+    /**
+     * Constructor.
+     * @param longPressMillis duration in millis before a kButtonEventLongPressed
+     *    is generated, 0 to disable long press events
+     */
+    explicit ButtonDebouncer(uint16_t longPressMillis = 1000) :
+        mLongPressMillis(longPressMillis)
+    {}
+
+    /** Reset the debouncer, assuming that no buttons are pressed. */
+    void begin(uint16_t nowMillis) {
+      mButtons = 0;
+      mCount0 = 0;
+      mCount1 = 0;
+      mLongPressed = 0;
+      mLastChangeMillis = nowMillis;
+      mHead = 0;
+      mNumEvents = 0;
+    }
+
+    /**
+     * Feed the raw button states, and generate the events for the buttons
+     * whose debounced state changed.
+     *
+     * @param rawButtons bit mask of buttons, 1 meaning pressed
+     * @param nowMillis the current millis, used for long press detection
+     */
+    void update(uint32_t rawButtons, uint16_t nowMillis) {
+      // Vertical counter: each bit position has its own 2-bit counter formed
+      // by (mCount1, mCount0), which is reset when the raw state agrees with
+      // the debounced state, and rolls over after 4 disagreeing samples.
+      uint32_t delta = rawButtons ^ mButtons;
+      mCount1 = (mCount1 ^ mCount0) & delta;
+      mCount0 = ~mCount0 & delta;
+      uint32_t toggled = delta & ~(mCount0 | mCount1);
+      mButtons ^= toggled;
+
+      if (toggled) {
+        pushEvents(toggled & mButtons, kButtonEventPressed);
+        pushEvents(toggled & ~mButtons, kButtonEventReleased);
+        mLongPressed &= mButtons;
+        mLastChangeMillis = nowMillis;
+      } else if (mLongPressMillis) {
+        uint32_t candidates = mButtons & ~mLongPressed;
+        if (candidates
+            && (uint16_t) (nowMillis - mLastChangeMillis) >= mLongPressMillis) {
+          pushEvents(candidates, kButtonEventLongPressed);
+          mLongPressed |= candidates;
+        }
+      }
+    }
+
+    /** Return the debounced state of the buttons, 1 meaning pressed. */
+    uint32_t getButtons() const { return mButtons; }
+
+    /** Return true if there is at least one event in the ring buffer. */
+    bool isEventAvailable() const { return mNumEvents != 0; }
+
+    /**
+     * Remove the oldest event from the ring buffer and copy it into `event`.
+     * Return false if there are no events.
+     */
+    bool readEvent(ButtonEvent& event) {
+      if (mNumEvents == 0) return false;
+
+      event = mEvents[mHead];
+      ace_common::incrementMod(mHead, T_QUEUE_SIZE);
+      mNumEvents--;
+      return true;
+    }
+
+  private:
+    /** Push an event of the given type for each 1 bit of buttons. */
+    void pushEvents(uint32_t buttons, uint8_t type) {
+      for (uint8_t button = 0; buttons; ++button, buttons >>= 1) {
+        if (! (buttons & 0x1)) continue;
+        if (mNumEvents >= T_QUEUE_SIZE) return;
+
+        uint8_t tail = mHead + mNumEvents;
+        if (tail >= T_QUEUE_SIZE) tail -= T_QUEUE_SIZE;
+        ButtonEvent& event = mEvents[tail];
+        event.type = type;
+        event.button = button;
+        mNumEvents++;
+      }
+    }
+
+  private:
+    /** Debounced state of the buttons. */
+    uint32_t mButtons;
+
+    /** Low bit of the vertical counter of each button. */
+    uint32_t mCount0;
+
+    /** High bit of the vertical counter of each button. */
+    uint32_t mCount1;
+
+    /** Buttons which have already generated a long press event. */
+    uint32_t mLongPressed;
+
+    /** Duration before a long press event, 0 to disable. */
+    uint16_t const mLongPressMillis;
+
+    /** Timestamp of the last change in the debounced state. */
+    uint16_t mLastChangeMillis;
+
+    /** Ring buffer of events. */
+    ButtonEvent mEvents[T_QUEUE_SIZE];
+
+    /** Index of the oldest event in mEvents. */
+    uint8_t mHead;
+
+    /** Number of events in mEvents. */
+    uint8_t mNumEvents;
+};
+
+} // ace_segment
+
+#endif
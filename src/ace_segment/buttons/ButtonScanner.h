@@ -0,0 +1,166 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_BUTTON_SCANNER_H
+#define ACE_SEGMENT_BUTTON_SCANNER_H
+
+#include <stdint.h>
+#include "../hw/ClockInterface.h" // ClockInterface
+#include "ButtonDebouncer.h"
+
+namespace ace_segment {
+
+/**
+ * The default policy of ButtonScanner, for an LED module with a controller
+ * chip. The key scan and the flush are both transactions with the controller,
+ * so only one of them is performed by each call to ButtonScanner::update().
+ */
+struct FlushIncrementalPolicy {
+  /** True if the module must be flushed even when the keys were scanned. */
+  static const bool kFlushOnScan = false;
+
+  /** Send one flushIncremental() stage to the module. */
+  template <typename T_MODULE>
+  static void flush(T_MODULE& module) { module.flushIncremental(); }
+};
+
+/**
+ * The policy of ButtonScanner for a ScanningModule. The keys are sampled by
+ * the LedMatrix while the fields are drawn, so the key scan only reads memory,
+ * and renderFieldWhenReady() is called on every update(), so that a field is
+ * not delayed by a key scan.
+ */
+struct RenderFieldPolicy {
+  static const bool kFlushOnScan = true;
+
+  /** Render the next field if it is due. */
+  template <typename T_MODULE>
+  static void flush(T_MODULE& module) { module.renderFieldWhenReady(); }
+};
+
+/**
+ * Scan the buttons of an LED module with a controller chip that supports a key
+ * matrix (e.g. Tm1637Module, Tm1638Module) at a fixed rate, interleaved with
+ * the incremental flushing of the display. Each call to update() performs at
+ * most one transaction with the controller: either a key scan, if the scan
+ * interval has elapsed, or a single flushIncremental() stage. A ScanningModule
+ * whose LedMatrix samples a key matrix can also be used with the
+ * RenderFieldPolicy, which renders the next field when it is due on every
+ * call, and reads the keys already sampled by the LedMatrix. The raw buttons
+ * are debounced in parallel using a ButtonDebouncer, which generates press,
+ * release and long press events into a small ring buffer.
+ *
+ * The debouncing takes 4 scans, so a scan interval of 5 ms gives a 20 ms
+ * debouncing time. The key reads happen only at the scan rate, instead of on
+ * every iteration of the global loop(), which avoids blocking the loop with
+ * redundant key reads.
+ *
+ * @tparam T_MODULE the LED module class, which must implement
+ *    readButtonBits(), and the flush method called by T_POLICY, which must
+ *    return immediately if there is nothing to do
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()). The default is ClockInterface.
+ * @tparam T_QUEUE_SIZE size of the event ring buffer (default 8)
+ * @tparam T_POLICY FlushIncrementalPolicy (default) for a module with a
+ *    controller chip, or RenderFieldPolicy for a ScanningModule
+ */
+template <
+    typename T_MODULE,
+    typename T_CI = ClockInterface,
+    uint8_t T_QUEUE_SIZE = 8,
+    typename T_POLICY = FlushIncrementalPolicy>
+class ButtonScanner {
+  public:
+    /**
+     * Constructor.
+     * @param module the LED module
+     * @param scanIntervalMillis interval between key scans, usually 5-10 ms
+     * @param longPressMillis duration before a long press event, 0 to disable
+     */
+    explicit ButtonScanner(
+        T_MODULE& module,
+        uint8_t scanIntervalMillis = 5,
+        uint16_t longPressMillis = 1000
+    ) :
+        mModule(module),
+        mDebouncer(longPressMillis),
+        mScanIntervalMillis(scanIntervalMillis)
+    {}
+
+    /** Initialize the scanner. The module must be initialized separately. */
+    void begin() {
+      mLastScanMillis = T_CI::millis();
+      mDebouncer.begin(mLastScanMillis);
+    }
+
+    /** A no-op end() function for consistency with other classes. */
+    void end() {}
+
+    /**
+     * Perform one unit of work: scan the buttons if the scan interval has
+     * elapsed, otherwise flush the module using T_POLICY. With the
+     * RenderFieldPolicy, the module is also flushed after a scan. Call this
+     * from the global loop() as often as possible.
+     *
+     * @return true if the buttons were scanned
+     */
+    bool update() {
+      uint16_t nowMillis = T_CI::millis();
+      if ((uint16_t) (nowMillis - mLastScanMillis) >= mScanIntervalMillis) {
+        mLastScanMillis = nowMillis;
+        mDebouncer.update(mModule.readButtonBits(), nowMillis);
+        if (T_POLICY::kFlushOnScan) {
+          T_POLICY::flush(mModule);
+        }
+        return true;
+      } else {
+        T_POLICY::flush(mModule);
+        return false;
+      }
+    }
+
+    /** Return the debounced state of the buttons, 1 meaning pressed. */
+    uint32_t getButtons() const { return mDebouncer.getButtons(); }
+
+    /** Return true if there is at least one button event. */
+    bool isEventAvailable() const { return mDebouncer.isEventAvailable(); }
+
+    /** Retrieve the oldest button event. Return false if there are none. */
+    bool readEvent(ButtonEvent& event) { return mDebouncer.readEvent(event); }
+
+  private:
+    // disable copy-constructor and assignment operator
+    ButtonScanner(const ButtonScanner&) = delete;
+    ButtonScanner& operator=(const ButtonScanner&) = delete;
+
+  private:
+    T_MODULE& mModule;
+    ButtonDebouncer<T_QUEUE_SIZE> mDebouncer;
+    uint8_t const mScanIntervalMillis;
+    uint16_t mLastScanMillis;
+};
+
+} // ace_segment
+
+#endif
@@ -58,14 +58,16 @@ template <
     typename T_CI = ClockInterface
 >
 class DirectFast4Module : public ScanningModule<
-    LedMatrixDirectFast4<e0, e1, e2, e3, e4, e5, e6, e7, g0, g1, g2, g3>,
+    OwnedLedMatrix<
+        LedMatrixDirectFast4<e0, e1, e2, e3, e4, e5, e6, e7, g0, g1, g2, g3>>,
     T_DIGITS,
     T_SUBFIELDS,
     T_CI
 > {
   private:
     using Super = ScanningModule<
-        LedMatrixDirectFast4<e0, e1, e2, e3, e4, e5, e6, e7, g0, g1, g2, g3>,
+        OwnedLedMatrix<LedMatrixDirectFast4<
+            e0, e1, e2, e3, e4, e5, e6, e7, g0, g1, g2, g3>>,
         T_DIGITS,
         T_SUBFIELDS,
         T_CI
@@ -77,26 +79,24 @@ class DirectFast4Module : public ScanningModule<
         uint8_t digitOnPattern,
         uint8_t framesPerSecond
     ) :
-        Super(mLedMatrix, framesPerSecond),
-        mLedMatrix(
-            segmentOnPattern /*elementOnPattern*/,
-            digitOnPattern /*groupOnPattern*/
+        Super(
+            typename Super::LedMatrix(
+                segmentOnPattern /*elementOnPattern*/,
+                digitOnPattern /*groupOnPattern*/
+            ),
+            framesPerSecond
         )
     {}
 
     void begin() {
-      mLedMatrix.begin();
+      Super::getLedMatrix().begin();
       Super::begin();
     }
 
     void end() {
-      mLedMatrix.end();
+      Super::getLedMatrix().end();
       Super::end();
     }
-
-  private:
-    LedMatrixDirectFast4<e0, e1, e2, e3, e4, e5, e6, e7, g0, g1, g2, g3>
-        mLedMatrix;
 };
 
 } // ace_segment
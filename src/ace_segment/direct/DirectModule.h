@@ -53,14 +53,14 @@ template <
     typename T_GPIOI = GpioInterface
 >
 class DirectModule : public ScanningModule<
-    LedMatrixDirect<T_GPIOI>,
+    OwnedLedMatrix<LedMatrixDirect<T_GPIOI>>,
     T_DIGITS,
     T_SUBFIELDS,
     T_CI
 > {
   private:
     using Super = ScanningModule<
-        LedMatrixDirect<T_GPIOI>,
+        OwnedLedMatrix<LedMatrixDirect<T_GPIOI>>,
         T_DIGITS,
         T_SUBFIELDS,
         T_CI
@@ -74,29 +74,28 @@ class DirectModule : public ScanningModule<
         const uint8_t* segmentPins,
         const uint8_t* digitPins
     ) :
-        Super(mLedMatrix, framesPerSecond),
-        mLedMatrix(
-            segmentOnPattern /*elementOnPattern*/,
-            digitOnPattern /*groupOnPattern*/,
-            8 /* numElements */,
-            segmentPins /*elementPins*/,
-            T_DIGITS /*numGroups*/,
-            digitPins /* groupPins */
+        Super(
+            LedMatrixDirect<T_GPIOI>(
+                segmentOnPattern /*elementOnPattern*/,
+                digitOnPattern /*groupOnPattern*/,
+                8 /* numElements */,
+                segmentPins /*elementPins*/,
+                T_DIGITS /*numGroups*/,
+                digitPins /* groupPins */
+            ),
+            framesPerSecond
         )
     {}
 
     void begin() {
-      mLedMatrix.begin();
+      Super::getLedMatrix().begin();
       Super::begin();
     }
 
     void end() {
-      mLedMatrix.end();
+      Super::getLedMatrix().end();
       Super::end();
     }
-
-  private:
-    LedMatrixDirect<T_GPIOI> mLedMatrix;
 };
 
 } // ace_segment
@@ -51,6 +51,12 @@ const uint8_t kByteOrderSegmentHighDigitLow = kByteOrderElementHighGroupLow;
  */
 extern const uint8_t kDigitRemapArray8Hc595[8];
 
+/**
+ * The compile-time version of kDigitRemapArray8Hc595, to be passed as the
+ * T_REMAP template parameter of Hc595Module.
+ */
+using DigitRemap8Hc595 = RemapSequence<4, 5, 6, 7, 0, 1, 2, 3>;
+
 /**
  * An implementation of LedModule class that supports an LED module using 2
  * 74HC595 Shift Register chips. This is a convenience class that pairs together
@@ -65,29 +71,48 @@ extern const uint8_t kDigitRemapArray8Hc595[8];
  *    get brightness control.
  * @tparam T_CI class that provides access to Arduino clock functions (millis()
  *    and micros()). The default is ClockInterface.
+ * @tparam T_PWMI (optional) class that writes the global brightness as a PWM
+ *    duty cycle to the output enable (OE) pin of the 74HC595 chips, usually
+ *    PwmInterface. This gives 256 brightness levels with T_SUBFIELDS = 1. The
+ *    default is NullPwmInterface which does not use the OE pin.
+ * @tparam T_REMAP (optional) class that remaps the logical digit positions to
+ *    their physical positions: RemapArray (default) which inverts the
+ *    remapArray given to the constructor into a RAM array, or a RemapSequence
+ *    fixed at compile-time which needs no RAM.
  */
 template <
     typename T_SPII,
     uint8_t T_DIGITS,
     uint8_t T_SUBFIELDS = 1,
-    typename T_CI = ClockInterface
+    typename T_CI = ClockInterface,
+    typename T_PWMI = NullPwmInterface,
+    typename T_REMAP = RemapArray
 >
 class Hc595Module : public ScanningModule<
-    LedMatrixDualHc595<T_SPII>,
+    OwnedLedMatrix<
+        LedMatrixDualHc595<T_SPII, T_PWMI, typename T_REMAP::Inverse>>,
     T_DIGITS,
     T_SUBFIELDS,
     T_CI
 > {
   private:
     using Super = ScanningModule<
-        LedMatrixDualHc595<T_SPII>,
+        OwnedLedMatrix<
+            LedMatrixDualHc595<T_SPII, T_PWMI, typename T_REMAP::Inverse>>,
         T_DIGITS,
         T_SUBFIELDS,
         T_CI
     >;
 
   public:
+    static_assert(! T_REMAP::kIsCompileTime
+        || T_REMAP::kNumPositions == T_DIGITS,
+        "T_REMAP must have T_DIGITS positions");
+
     /**
+     * Constructor without the OE pin, available only if T_PWMI is a no-op
+     * (e.g. NullPwmInterface).
+     *
      * @param spiInterface object that knows how to send SPI packets
      * @param segmentOnPattern the bit pattern that indicates whether the
      *    segment pins are wired to be active high (kActiveHighPattern)
@@ -111,38 +136,84 @@ class Hc595Module : public ScanningModule<
         uint8_t digitOnPattern,
         uint8_t framesPerSecond,
         uint8_t byteOrder,
-        const uint8_t* remapArray = nullptr
+        typename T_REMAP::Argument remapArray = nullptr
     ) :
-        Super(mLedMatrix, framesPerSecond),
-        mLedMatrix(
+        Hc595Module(
             spiInterface,
-            segmentOnPattern /*elementOnPattern*/,
-            digitOnPattern /*groupOnPattern*/,
+            segmentOnPattern,
+            digitOnPattern,
+            framesPerSecond,
             byteOrder,
-            remapArray ? mRemapArrayInverted : nullptr
+            remapArray,
+            0 /*outputEnablePin*/)
+    {
+      static_assert(! T_PWMI::kEnabled,
+          "outputEnablePin is required if T_PWMI is enabled");
+    }
+
+    /**
+     * Constructor with the OE pin, required if T_PWMI is enabled. The other
+     * parameters are the same as above, except that `remapArray` must be
+     * given (possibly nullptr) before the pin.
+     *
+     * @param outputEnablePin PWM-capable pin wired to the OE pin of the
+     *    74HC595 chips, ignored if T_PWMI is NullPwmInterface
+     */
+    Hc595Module(
+        const T_SPII& spiInterface,
+        uint8_t segmentOnPattern,
+        uint8_t digitOnPattern,
+        uint8_t framesPerSecond,
+        uint8_t byteOrder,
+        typename T_REMAP::Argument remapArray,
+        uint8_t outputEnablePin
+    ) :
+        Super(
+            typename Super::LedMatrix(
+                spiInterface,
+                segmentOnPattern /*elementOnPattern*/,
+                digitOnPattern /*groupOnPattern*/,
+                byteOrder,
+                invertedArgument(remapArray, mRemapArrayInverted),
+                outputEnablePin
+            ),
+            framesPerSecond
         )
     {
       // LedMatrixDualHc595 needs the inverted mapping.
-      if (remapArray) {
+      if (! T_REMAP::kIsCompileTime && remapArray != nullptr) {
         internal::invertRemapArray(mRemapArrayInverted, remapArray, T_DIGITS);
       }
     }
 
     void begin() {
-      mLedMatrix.begin();
+      Super::getLedMatrix().begin();
       Super::begin();
     }
 
     void end() {
-      mLedMatrix.end();
+      Super::getLedMatrix().end();
       Super::end();
     }
 
   private:
-    LedMatrixDualHc595<T_SPII> mLedMatrix;
+    /** Return the remapArrayInverted argument of LedMatrixDualHc595. */
+    static const uint8_t* invertedArgument(
+        const uint8_t* remapArray, const uint8_t* remapArrayInverted) {
+      return remapArray ? remapArrayInverted : nullptr;
+    }
+
+    /** A RemapSequence takes no array. */
+    static decltype(nullptr) invertedArgument(
+        decltype(nullptr), const uint8_t* /*remapArrayInverted*/) {
+      return nullptr;
+    }
 
-    /** The inverted mapping, from physical to logical positions. */
-    uint8_t mRemapArrayInverted[T_DIGITS];
+    /**
+     * The inverted mapping, from physical to logical positions. Used only by
+     * RemapArray, otherwise reduced to a single unused byte.
+     */
+    uint8_t mRemapArrayInverted[T_REMAP::kIsCompileTime ? 1 : T_DIGITS];
 };
 
 } // ace_segment
@@ -27,6 +27,7 @@ SOFTWARE.
 
 #include <stdint.h>
 #include <string.h> // memset()
+#include "../hw/ClockInterface.h"
 #include "../LedModule.h"
 
 class Ht16k33ModuleTest_patternForChipPos_colonDisabled;
@@ -61,9 +62,14 @@ namespace ace_segment {
  * @tparam T_DIGITS number of logical digits in the module. Currently this
  *    should always be set to 4 because it is designed to support the 4-digit
  *    LED modules found on Adafruit, Amazon or eBay.
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()), used to evaluate the Styler.
  */
-template <typename T_WIREI, uint8_t T_DIGITS>
-class Ht16k33Module : public LedModule {
+template <
+    typename T_WIREI,
+    uint8_t T_DIGITS,
+    typename T_CI = ClockInterface>
+class Ht16k33Module : public LedModule, public AutoPowerDown {
   public:
     /**
      * Constructor.
@@ -91,8 +97,10 @@ class Ht16k33Module : public LedModule {
 
     void begin() {
       LedModule::begin();
+      beginPowerDown();
 
       memset(mPatterns, 0, T_DIGITS);
+      mStepPos = kStepDone;
       writeCommand(kSystemOn);
       writeCommand(kDisplayOn);
     }
@@ -147,14 +155,38 @@ class Ht16k33Module : public LedModule {
      *
      * The isFlushRequired() method can be used to optimize the number of calls
      * to flush(), but often it is not necessary.
+     *
+     * If setAutoPowerDown() is enabled, a blank display turns off the display
+     * and puts the chip in standby mode, and nothing else is sent until a
+     * digit becomes non-blank.
      */
     void flush() {
+      // Apply the styles of the Styler, if any, to a temporary copy.
+      if (getStyler()) updateStyler(T_CI::millis());
+
+      const bool isPowerChanged =
+          updatePowerDown(isAutoPowerDown() && isBlank());
+      if (isPoweredDown()) {
+        if (isPowerChanged) {
+          writeCommand(kDisplayOff);
+          writeCommand(kSystemOff);
+        }
+        clearDigitsDirty();
+        clearBrightnessDirty();
+        return;
+      }
+      if (isPowerChanged) {
+        writeCommand(kSystemOn);
+      }
+      uint8_t styledPatterns[T_DIGITS];
+      const uint8_t* patterns = getStyledPatterns(styledPatterns);
+
       // Write digits.
       mWireInterface.beginTransmission(mAddr);
       mWireInterface.write(0x00); // start at position 0
       // Loop over the 5 physical digit lines of this module.
       for (uint8_t chipPos = 0; chipPos < T_DIGITS + 1; ++chipPos) {
-        uint8_t pattern = patternForChipPos(chipPos, mPatterns, mEnableColon);
+        uint8_t pattern = patternForChipPos(chipPos, patterns, mEnableColon);
         mWireInterface.write(pattern); // ROW0-ROW7
         mWireInterface.write(0); // ROW8-ROW15 unused
       }
@@ -162,15 +194,134 @@ class Ht16k33Module : public LedModule {
 
       // Write brightness.
       writeCommand(getBrightness() | kBrightness);
+      if (isPowerChanged) {
+        writeCommand(kDisplayOn);
+      }
 
       clearDigitsDirty();
       clearBrightnessDirty();
     }
 
+    /**
+     * Start a resumable flush of all digits and the brightness, which is
+     * performed by calling step() until it returns false. The same data as
+     * flush() is sent, including the commands of the automatic power-down,
+     * but in pieces of a bounded size. The dirty bits are cleared here, so a
+     * digit which is changed during the flush is flushed again later. Calling
+     * this while a flush is in progress restarts it.
+     */
+    void startFlush() {
+      if (getStyler()) updateStyler(T_CI::millis());
+      mIsStepPowerChanged = updatePowerDown(isAutoPowerDown() && isBlank());
+      clearDigitsDirty();
+      clearBrightnessDirty();
+
+      if (! isPoweredDown()) {
+        if (mIsStepPowerChanged) {
+          mStepPos = kStepSystemOn;
+        } else {
+          mStepPos = kStepDigits;
+        }
+      } else if (mIsStepPowerChanged) {
+        mStepPos = kStepDisplayOff;
+      } else {
+        mStepPos = kStepDone;
+      }
+    }
+
+    /**
+     * Perform the next part of the flush started by startFlush(), sending at
+     * most `budgetBytes` bytes, not counting the I2C address. Each command
+     * takes 1 byte, and a run of physical digits takes 1 byte for the starting
+     * address plus 2 bytes per digit. At least one transmission is always
+     * sent, even if it exceeds the budget, so that every call makes progress.
+     *
+     * @return true if more steps are required, false if the flush is done or
+     *    was never started
+     */
+    bool step(uint8_t budgetBytes) {
+      uint8_t numBytes = 0;
+
+      while (mStepPos != kStepDone) {
+        if (mStepPos >= kStepDigits && mStepPos < kStepBrightness) {
+          if (numBytes != 0 && numBytes + 3 > budgetBytes) break;
+
+          // Style only the digits sent by this step. patternForChipPos()
+          // reads only the entry of the digit behind chipPos.
+          uint8_t styledPatterns[T_DIGITS];
+          mWireInterface.beginTransmission(mAddr);
+          mWireInterface.write((mStepPos - kStepDigits) * 2);
+          numBytes++;
+          do {
+            uint8_t chipPos = mStepPos - kStepDigits;
+            uint8_t digit = digitForChipPos(chipPos);
+            styledPatterns[digit] = getStyledPatternAt(digit);
+            mWireInterface.write(
+                patternForChipPos(chipPos, styledPatterns, mEnableColon));
+            mWireInterface.write(0); // ROW8-ROW15 unused
+            numBytes += 2;
+            mStepPos++;
+          } while (mStepPos < kStepBrightness && numBytes + 2 <= budgetBytes);
+
+          // A repeated START is used only if the brightness command follows
+          // in this step. Otherwise the STOP releases the bus for the other
+          // users of the Wire interface until the next step.
+          bool isBrightnessNext = mStepPos == kStepBrightness
+              && numBytes + 1 <= budgetBytes;
+          mWireInterface.endTransmission(! isBrightnessNext);
+          continue;
+        }
+
+        if (numBytes != 0 && numBytes + 1 > budgetBytes) break;
+        switch (mStepPos) {
+          case kStepSystemOn:
+            writeCommand(kSystemOn);
+            mStepPos = kStepDigits;
+            break;
+          case kStepBrightness:
+            writeCommand(getBrightness() | kBrightness);
+            if (mIsStepPowerChanged) {
+              mStepPos = kStepDisplayOn;
+            } else {
+              mStepPos = kStepDone;
+            }
+            break;
+          case kStepDisplayOn:
+            writeCommand(kDisplayOn);
+            mStepPos = kStepDone;
+            break;
+          case kStepDisplayOff:
+            writeCommand(kDisplayOff);
+            mStepPos = kStepSystemOff;
+            break;
+          default: // kStepSystemOff
+            writeCommand(kSystemOff);
+            mStepPos = kStepDone;
+            break;
+        }
+        numBytes++;
+      }
+
+      return mStepPos != kStepDone;
+    }
+
   private:
     friend class ::Ht16k33ModuleTest_patternForChipPos_colonDisabled;
     friend class ::Ht16k33ModuleTest_patternForChipPos_colonEnabled;
 
+    /**
+     * Return the patterns after applying the Styler, using `styledPatterns` as
+     * the buffer if a Styler is attached.
+     */
+    const uint8_t* getStyledPatterns(uint8_t styledPatterns[]) const {
+      if (! getStyler()) return mPatterns;
+
+      for (uint8_t pos = 0; pos < T_DIGITS; ++pos) {
+        styledPatterns[pos] = getStyledPatternAt(pos);
+      }
+      return styledPatterns;
+    }
+
     /** Write a single byte command to the LED module. */
     void writeCommand(uint8_t command) {
       mWireInterface.beginTransmission(mAddr);
@@ -178,6 +329,14 @@ class Ht16k33Module : public LedModule {
       mWireInterface.endTransmission();
     }
 
+    /**
+     * Return the logical digit whose pattern is sent to the given physical
+     * digit position. The colon at COM2 uses the bit 7 of digit 1.
+     */
+    static uint8_t digitForChipPos(uint8_t chipPos) {
+      return (chipPos < 2) ? chipPos : chipPos - 1;
+    }
+
     /**
      * Return the segment pattern appropriate for the given physical digit
      * position (COM{N}}. This function is static for unit testing purposes.
@@ -220,6 +379,16 @@ class Ht16k33Module : public LedModule {
     static uint8_t const kDisplayOn  = 0x81;
     static uint8_t const kBrightness = 0xE0;
 
+    // Positions of the resumable flush. The (T_DIGITS + 1) physical digits
+    // start at kStepDigits.
+    static uint8_t const kStepSystemOn = 0;
+    static uint8_t const kStepDigits = 1;
+    static uint8_t const kStepBrightness = kStepDigits + T_DIGITS + 1;
+    static uint8_t const kStepDisplayOn = kStepBrightness + 1;
+    static uint8_t const kStepDisplayOff = 0xFD;
+    static uint8_t const kStepSystemOff = 0xFE;
+    static uint8_t const kStepDone = 0xFF;
+
     /**
      * I2C Wire interface. Copied by value instead of reference to avoid an
      * extra layer of indirection.
@@ -234,6 +403,12 @@ class Ht16k33Module : public LedModule {
 
     /** Enable colon. */
     bool mEnableColon;
+
+    /** Position of the resumable flush, or kStepDone. */
+    uint8_t mStepPos;
+
+    /** The power state changed at the last startFlush(). */
+    bool mIsStepPowerChanged;
 };
 
 }
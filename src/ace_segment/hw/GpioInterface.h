@@ -47,6 +47,15 @@ class GpioInterface {
     #endif
     }
 
+    /** Read value of pin. */
+    static uint8_t digitalRead(uint8_t pin) {
+    #if defined(ARDUINO_API_VERSION)
+      return arduino::digitalRead(pin);
+    #else
+      return ::digitalRead(pin);
+    #endif
+    }
+
     /** Set pin mode. */
     static void pinMode(uint8_t pin, uint8_t mode) {
     #if defined(ARDUINO_API_VERSION)
@@ -0,0 +1,67 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_PWM_INTERFACE_H
+#define ACE_SEGMENT_PWM_INTERFACE_H
+
+#include <stdint.h>
+#include <Arduino.h>
+
+namespace ace_segment {
+
+/**
+ * A thin layer of indirection to the hardware PWM function `analogWrite()`.
+ * The pin must be PWM-capable. This allows injection of a different
+ * PwmInterface for testing purposes.
+ */
+class PwmInterface {
+  public:
+    /** True if analogWrite() drives the pin. */
+    static const bool kEnabled = true;
+
+    /** Write the PWM duty cycle (0-255) to the pin. */
+    static void analogWrite(uint8_t pin, uint8_t value) {
+    #if defined(ARDUINO_API_VERSION)
+      arduino::analogWrite(pin, value);
+    #else
+      ::analogWrite(pin, value);
+    #endif
+    }
+};
+
+/**
+ * A PwmInterface which does nothing. This is the default for the LED matrix
+ * classes which can optionally drive a PWM pin, so that no PWM code is pulled
+ * in unless it is explicitly requested.
+ */
+class NullPwmInterface {
+  public:
+    static const bool kEnabled = false;
+
+    static void analogWrite(uint8_t /*pin*/, uint8_t /*value*/) {}
+};
+
+}
+
+#endif
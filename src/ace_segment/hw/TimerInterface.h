@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_TIMER_INTERFACE_H
+#define ACE_SEGMENT_TIMER_INTERFACE_H
+
+#include <stdint.h>
+
+namespace ace_segment {
+
+/** Type of the interrupt service routine called by a TimerInterface. */
+typedef void (*TimerIsr)();
+
+/**
+ * A utility class (all methods are static) that defines the interface to a
+ * periodic hardware timer, used by ScanningTimer to call
+ * ScanningModule::renderFieldNow() from an interrupt. This is a template
+ * concept: the class passed as the `T_TI` template parameter must provide the
+ * same static methods.
+ *
+ * This implementation does nothing. The Arduino API does not define timer
+ * interrupts, so the application provides the real implementation, usually a
+ * thin wrapper around a library like TimerOne:
+ *
+ * @code{.cpp}
+ * class TimerOneInterface {
+ *   public:
+ *     static void begin(uint32_t periodMicros, TimerIsr isr) {
+ *       Timer1.initialize(periodMicros);
+ *       Timer1.attachInterrupt(isr);
+ *     }
+ *     static void setPeriod(uint32_t periodMicros) {
+ *       Timer1.setPeriod(periodMicros);
+ *     }
+ *     static void end() {
+ *       Timer1.detachInterrupt();
+ *       Timer1.stop();
+ *     }
+ * };
+ * @endcode
+ *
+ * The TestableTimerInterface class provides a fake timer for unit tests.
+ */
+class TimerInterface {
+  public:
+    /** Start calling `isr` every `periodMicros`. */
+    static void begin(uint32_t /*periodMicros*/, TimerIsr /*isr*/) {}
+
+    /** Change the period of a running timer. */
+    static void setPeriod(uint32_t /*periodMicros*/) {}
+
+    /** Stop the timer and detach the isr. */
+    static void end() {}
+};
+
+}
+
+#endif
@@ -26,6 +26,7 @@ SOFTWARE.
 #define ACE_SEGMENT_REMAP_H
 
 #include <stdint.h>
+#include "../index_list.h" // IndexList, MakeIndexList
 
 namespace ace_segment {
 namespace internal {
@@ -42,6 +43,124 @@ inline void invertRemapArray(uint8_t dst[], const uint8_t src[], uint8_t len) {
   }
 }
 
+/** Return the index of the value in the sequence T_FIRST, T_REST... */
+template <uint8_t T_FIRST>
+constexpr uint8_t sequenceIndexOf(uint8_t /*value*/, uint8_t index = 0) {
+  return index;
+}
+
+template <uint8_t T_FIRST, uint8_t T_SECOND, uint8_t... T_REST>
+constexpr uint8_t sequenceIndexOf(uint8_t value, uint8_t index = 0) {
+  return (T_FIRST == value)
+      ? index
+      : sequenceIndexOf<T_SECOND, T_REST...>(value, index + 1);
+}
+
+template <typename T_INDEXES, uint8_t... T_POSITIONS>
+struct InverseRemapSequence;
+
+} // namespace internal
+
+/**
+ * Remap of the digit positions using an array given at runtime, such that
+ * `physicalPos = remapArray[logicalPos]`, or no remap if the array is nullptr.
+ * This is the default T_REMAP template parameter of the LedModule classes
+ * which accept a `remapArray` in their constructor.
+ */
+class RemapArray {
+  public:
+    /** The remap is given at runtime. */
+    static const bool kIsCompileTime = false;
+
+    /** The number of positions is not known at compile-time. */
+    static const uint8_t kNumPositions = 0;
+
+    /**
+     * The inverse mapping is also a RemapArray, of an array inverted at
+     * runtime by invertRemapArray().
+     */
+    using Inverse = RemapArray;
+
+    /** Type of the `remapArray` argument of the LedModule constructors. */
+    typedef const uint8_t* Argument;
+
+    explicit RemapArray(const uint8_t* remapArray) :
+        mRemapArray(remapArray)
+    {}
+
+    /** Return true if the positions are remapped. */
+    bool isRemapped() const { return mRemapArray != nullptr; }
+
+    /** Convert the logical position into the physical position. */
+    uint8_t remap(uint8_t pos) const {
+      return mRemapArray ? mRemapArray[pos] : pos;
+    }
+
+  private:
+    const uint8_t* const mRemapArray;
+};
+
+/**
+ * Remap of the digit positions fixed at compile-time, such that
+ * `physicalPos = T_POSITIONS[logicalPos]`. Unlike RemapArray, this adds no
+ * member to the LedModule when used as the T_REMAP template parameter. The
+ * remap of a position known at compile-time folds into a constant, but the
+ * flush loops of the modules iterate over a runtime number of digits, so in
+ * practice each remap is a single lookup in the static kPositions table. The
+ * `remapArray` argument of the constructor of the LedModule has the type
+ * `std::nullptr_t`, so that passing an array is a compile-time error. The
+ * LedModule checks that the number of positions is T_DIGITS.
+ *
+ * For example, `RemapSequence<2, 1, 0, 5, 4, 3>` is the compile-time version
+ * of `kDigitRemapArray6Tm1637`.
+ */
+template <uint8_t... T_POSITIONS>
+class RemapSequence {
+  public:
+    /** The remap is fixed at compile-time. */
+    static const bool kIsCompileTime = true;
+
+    /** Number of positions, which must be the number of digits. */
+    static const uint8_t kNumPositions = sizeof...(T_POSITIONS);
+
+    /** The physical position of each logical position. */
+    static constexpr uint8_t kPositions[sizeof...(T_POSITIONS)] = {
+        T_POSITIONS...
+    };
+
+    /** The inverse mapping, from the physical to the logical positions. */
+    using Inverse = typename internal::InverseRemapSequence<
+        typename internal::MakeIndexList<sizeof...(T_POSITIONS)>::type,
+        T_POSITIONS...
+    >::type;
+
+    /**
+     * Type of the `remapArray` argument of the LedModule constructors, which
+     * accepts only nullptr.
+     */
+    typedef decltype(nullptr) Argument;
+
+    explicit RemapSequence(Argument /*remapArray*/ = nullptr) {}
+
+    /** Return true if the positions are remapped. */
+    static constexpr bool isRemapped() { return true; }
+
+    /** Convert the logical position into the physical position. */
+    static constexpr uint8_t remap(uint8_t pos) {
+      return kPositions[pos];
+    }
+};
+
+template <uint8_t... T_POSITIONS>
+constexpr uint8_t RemapSequence<T_POSITIONS...>::kPositions[];
+
+namespace internal {
+
+template <uint8_t... Is, uint8_t... T_POSITIONS>
+struct InverseRemapSequence<IndexList<Is...>, T_POSITIONS...> {
+  typedef RemapSequence<sequenceIndexOf<T_POSITIONS...>(Is)...> type;
+};
+
 } // namespace internal
 } // namespace ace_segment
 
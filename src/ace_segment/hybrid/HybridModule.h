@@ -55,14 +55,14 @@ template <
     typename T_GPIOI = GpioInterface
 >
 class HybridModule : public ScanningModule<
-    LedMatrixSingleHc595<T_SPII, T_GPIOI>,
+    OwnedLedMatrix<LedMatrixSingleHc595<T_SPII, T_GPIOI>>,
     T_DIGITS,
     T_SUBFIELDS,
     T_CI
 > {
   private:
     using Super = ScanningModule<
-        LedMatrixSingleHc595<T_SPII, T_GPIOI>,
+        OwnedLedMatrix<LedMatrixSingleHc595<T_SPII, T_GPIOI>>,
         T_DIGITS,
         T_SUBFIELDS,
         T_CI
@@ -76,28 +76,27 @@ class HybridModule : public ScanningModule<
         uint8_t framesPerSecond,
         const uint8_t* digitPins
     ) :
-        Super(mLedMatrix, framesPerSecond),
-        mLedMatrix(
-            spiInterface,
-            segmentOnPattern /*elementOnPattern*/,
-            digitOnPattern /*groupOnPattern*/,
-            T_DIGITS /*numGroups*/,
-            digitPins /*groupPins*/
+        Super(
+            LedMatrixSingleHc595<T_SPII, T_GPIOI>(
+                spiInterface,
+                segmentOnPattern /*elementOnPattern*/,
+                digitOnPattern /*groupOnPattern*/,
+                T_DIGITS /*numGroups*/,
+                digitPins /*groupPins*/
+            ),
+            framesPerSecond
         )
     {}
 
     void begin() {
-      mLedMatrix.begin();
+      Super::getLedMatrix().begin();
       Super::begin();
     }
 
     void end() {
-      mLedMatrix.end();
+      Super::getLedMatrix().end();
       Super::end();
     }
-
-  private:
-    LedMatrixSingleHc595<T_SPII, T_GPIOI> mLedMatrix;
 };
 
 } // ace_segment
@@ -26,7 +26,8 @@ SOFTWARE.
 #define ACE_SEGMENT_MAX7219_MODULE_H
 
 #include <stdint.h>
-#include <string.h> // memset()
+#include "../hw/ClockInterface.h"
+#include "../hw/remap.h"
 #include "../LedModule.h"
 
 namespace ace_segment {
@@ -96,29 +97,47 @@ inline uint8_t convertPatternMax7219(uint8_t pattern) {
 extern const uint8_t kDigitRemapArray8Max7219[8];
 
 /**
- * An implementation of LedModule using the MAX7219 chip. The chip uses SPI.
+ * The compile-time version of kDigitRemapArray8Max7219, to be passed as the
+ * T_REMAP template parameter of Max7219Module.
+ */
+using DigitRemap8Max7219 = RemapSequence<7, 6, 5, 4, 3, 2, 1, 0>;
+
+/**
+ * The part of Max7219Module which does not depend on the number of digits, so
+ * that modules with different numbers of digits on the same SPI interface
+ * share a single copy of this code in flash.
  *
  * @tparam T_SPII class that implements the SPI interface, usually one of the
  *    classes in the AceSPI library: SimpleSpiInterface, SimpleSpiFastInterface,
  *    HardSpiInterface, HardSpiFastInterface.
- * @tparam T_DIGITS number of digits in the module
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()), used to evaluate the Styler.
+ * @tparam T_REMAP class that remaps the logical digit positions to their
+ *    physical positions, RemapArray or a RemapSequence
  */
-template <typename T_SPII, uint8_t T_DIGITS>
-class Max7219Module : public LedModule {
+template <typename T_SPII, typename T_CI, typename T_REMAP>
+class Max7219ModuleBase :
+    public LedModule,
+    public AutoPowerDown,
+    private T_REMAP {
   public:
     /**
      * Constructor.
      * @param spiInterface instance of SPI interface class
-     * @param remapArray (optional, nullable) a mapping of the physical digit
-     *    positions to their logical positions
+     * @param patterns array of segment patterns, one for each digit
+     * @param numDigits number of digits in the module
+     * @param remapArray (nullable) a mapping of the physical digit positions
+     *    to their logical positions
      */
-    explicit Max7219Module(
+    explicit Max7219ModuleBase(
         const T_SPII& spiInterface,
-        const uint8_t* remapArray = nullptr
+        uint8_t* patterns,
+        uint8_t numDigits,
+        typename T_REMAP::Argument remapArray
     ) :
-        LedModule(mPatterns, T_DIGITS),
-        mSpiInterface(spiInterface),
-        mRemapArray(remapArray)
+        LedModule(patterns, numDigits),
+        T_REMAP(remapArray),
+        mSpiInterface(spiInterface)
     {}
 
     //-----------------------------------------------------------------------
@@ -127,8 +146,10 @@ class Max7219Module : public LedModule {
 
     void begin() {
       LedModule::begin();
+      beginPowerDown();
 
-      memset(mPatterns, 0, T_DIGITS);
+      clearPatterns();
+      mStepPos = kStepDone;
 
       // Set to a non-zero value to avoid using uninitialized value.
       setBrightness(1);
@@ -167,29 +188,111 @@ class Max7219Module : public LedModule {
      *
      * The isFlushRequired() method can be used to optimize the number of calls
      * to flush(), but often it is not necessary.
+     *
+     * If setAutoPowerDown() is enabled, a blank display puts the chip in
+     * shutdown mode, and nothing else is sent until a digit becomes non-blank.
      */
     void flush() {
-      for (uint8_t chipPos = 0; chipPos < T_DIGITS; ++chipPos) {
+      if (getStyler()) updateStyler(T_CI::millis());
+
+      const bool isPowerChanged =
+          updatePowerDown(isAutoPowerDown() && isBlank());
+      if (isPoweredDown()) {
+        if (isPowerChanged) {
+          mSpiInterface.send16(kRegisterShutdown, 0x0); // turn off
+        }
+        clearDigitsDirty();
+        clearBrightnessDirty();
+        return;
+      }
+
+      const uint8_t numDigits = getNumDigits();
+      for (uint8_t chipPos = 0; chipPos < numDigits; ++chipPos) {
         // Remap the logical position used by the controller to the actual
         // position. For example, if the controller digit 0 appears at physical
         // digit 2, we need to display the segment pattern given by logical
         // position 2 when sending the byte to controller digit 0.
         uint8_t physicalPos = remapLogicalToPhysical(chipPos);
         uint8_t convertedPattern = internal::convertPatternMax7219(
-            mPatterns[physicalPos]);
+            getStyledPatternAt(physicalPos));
         mSpiInterface.send16(chipPos + 1, convertedPattern);
       }
 
       mSpiInterface.send16(kRegisterIntensity, getBrightness());
+      if (isPowerChanged) {
+        mSpiInterface.send16(kRegisterShutdown, 0x1); // turn on
+      }
+
+      clearDigitsDirty();
+      clearBrightnessDirty();
+    }
 
+    /**
+     * Start a resumable flush of all digits and the brightness, which is
+     * performed by calling step() until it returns false. The same data as
+     * flush() is sent, including the shutdown register of the automatic
+     * power-down, but in pieces of a bounded size. The dirty bits are cleared
+     * here, so a digit which is changed during the flush is flushed again
+     * later. Calling this while a flush is in progress restarts it.
+     */
+    void startFlush() {
+      if (getStyler()) updateStyler(T_CI::millis());
+      mIsStepPowerChanged = updatePowerDown(isAutoPowerDown() && isBlank());
       clearDigitsDirty();
       clearBrightnessDirty();
+
+      if (! isPoweredDown()) {
+        mStepPos = 0;
+      } else if (mIsStepPowerChanged) {
+        mStepPos = kStepShutdown;
+      } else {
+        mStepPos = kStepDone;
+      }
+    }
+
+    /**
+     * Perform the next part of the flush started by startFlush(), sending at
+     * most `budgetBytes` bytes. Each register write takes 2 bytes, one for each
+     * digit, then the intensity, then the shutdown register if the power state
+     * changed. At least one register is always written, even if it exceeds the
+     * budget, so that every call makes progress.
+     *
+     * @return true if more steps are required, false if the flush is done or
+     *    was never started
+     */
+    bool step(uint8_t budgetBytes) {
+      const uint8_t numDigits = getNumDigits();
+      uint8_t numBytes = 0;
+
+      while (mStepPos != kStepDone
+          && (numBytes == 0 || numBytes + 2 <= budgetBytes)) {
+        if (mStepPos < numDigits) {
+          uint8_t physicalPos = remapLogicalToPhysical(mStepPos);
+          uint8_t convertedPattern = internal::convertPatternMax7219(
+              getStyledPatternAt(physicalPos));
+          mSpiInterface.send16(mStepPos + 1, convertedPattern);
+          mStepPos++;
+        } else if (mStepPos == numDigits) {
+          mSpiInterface.send16(kRegisterIntensity, getBrightness());
+          if (mIsStepPowerChanged) {
+            mStepPos = kStepShutdown;
+          } else {
+            mStepPos = kStepDone;
+          }
+        } else {
+          mSpiInterface.send16(kRegisterShutdown, isPoweredDown() ? 0x0 : 0x1);
+          mStepPos = kStepDone;
+        }
+        numBytes += 2;
+      }
+
+      return mStepPos != kStepDone;
     }
 
   private:
     /** Convert a logical position into its physical position. */
     uint8_t remapLogicalToPhysical(uint8_t pos) const {
-      return mRemapArray ? mRemapArray[pos] : pos;
+      return T_REMAP::remap(pos);
     }
 
   private:
@@ -208,15 +311,65 @@ class Max7219Module : public LedModule {
     static uint8_t const kRegisterShutdown    = 0x0C;
     static uint8_t const kRegisterDisplayTest = 0x0F;
 
+    // Positions of the resumable flush after the digits and the intensity.
+    static uint8_t const kStepShutdown = 0xFE;
+    static uint8_t const kStepDone = 0xFF;
+
     /**
      * SPI interface object. Copied by value instead of reference to avoid an
      * extra level of indirection.
      */
     const T_SPII mSpiInterface;
 
-    /** Array to map digit addresses. */
-    const uint8_t* const mRemapArray;
+    /** Position of the resumable flush, or kStepDone. */
+    uint8_t mStepPos;
+
+    /** The power state changed at the last startFlush(). */
+    bool mIsStepPowerChanged;
+};
+
+/**
+ * An implementation of LedModule using the MAX7219 chip. The chip uses SPI.
+ * This class only provides the storage of the segment patterns, the logic is
+ * in Max7219ModuleBase.
+ *
+ * @tparam T_SPII class that implements the SPI interface, usually one of the
+ *    classes in the AceSPI library: SimpleSpiInterface, SimpleSpiFastInterface,
+ *    HardSpiInterface, HardSpiFastInterface.
+ * @tparam T_DIGITS number of digits in the module
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()), used to evaluate the Styler.
+ * @tparam T_REMAP class that remaps the logical digit positions to their
+ *    physical positions: RemapArray (default) which uses the remapArray given
+ *    to the constructor, or a RemapSequence fixed at compile-time which uses
+ *    no RAM.
+ */
+template <
+    typename T_SPII,
+    uint8_t T_DIGITS,
+    typename T_CI = ClockInterface,
+    typename T_REMAP = RemapArray>
+class Max7219Module : public Max7219ModuleBase<T_SPII, T_CI, T_REMAP> {
+  public:
+    static_assert(! T_REMAP::kIsCompileTime
+        || T_REMAP::kNumPositions == T_DIGITS,
+        "T_REMAP must have T_DIGITS positions");
+
+    /**
+     * Constructor.
+     * @param spiInterface instance of SPI interface class
+     * @param remapArray (optional, nullable) a mapping of the physical digit
+     *    positions to their logical positions
+     */
+    explicit Max7219Module(
+        const T_SPII& spiInterface,
+        typename T_REMAP::Argument remapArray = nullptr
+    ) :
+        Max7219ModuleBase<T_SPII, T_CI, T_REMAP>(
+            spiInterface, mPatterns, T_DIGITS, remapArray)
+    {}
 
+  private:
     /** Pattern for each digit. */
     uint8_t mPatterns[T_DIGITS];
 };
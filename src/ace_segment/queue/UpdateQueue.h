@@ -0,0 +1,195 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_UPDATE_QUEUE_H
+#define ACE_SEGMENT_UPDATE_QUEUE_H
+
+#include <stdint.h>
+
+namespace ace_segment {
+
+/**
+ * A fixed-capacity, lock-free, single-producer/single-consumer queue of
+ * updates to an LedModule. The producer (the main loop, or another task)
+ * enqueues setPatternAt() and setBrightness() commands, and the consumer (the
+ * timer ISR which calls ScanningModule::renderFieldNow(), or the task which
+ * calls flush()) applies them to the module at a point where it is not in the
+ * middle of rendering. The patterns and the dirty bits of the LedModule are
+ * then only ever touched by the consumer.
+ *
+ * Nothing in this library calls apply(). In particular, the isr() of
+ * ScanningTimer and ScanningScheduler only render the fields, so an
+ * application which uses the queue with a ScanningModule must call apply()
+ * from its own ISR, just before renderFieldNow().
+ *
+ * Both sides are wait-free: a push into a full queue returns false instead of
+ * blocking, and apply() processes only the commands which were published
+ * before it started. Nothing is allocated. The read and write indexes are
+ * free-running 8-bit counters, each written by only one side, and published
+ * using the GCC `__atomic` builtins with release/acquire ordering. On AVR,
+ * these compile to plain byte loads and stores with a compiler barrier.
+ *
+ * A setPatterns() of several digits is published with a single store of the
+ * write index, so apply() sees either all or none of its digits, and the
+ * display never shows a partially written bulk update.
+ *
+ * There must be exactly one producer and one consumer. Multiple producers must
+ * be serialized by the application.
+ *
+ * @tparam T_CAPACITY maximum number of commands, a power of 2 in the range
+ *    [2, 128]
+ */
+template <uint8_t T_CAPACITY>
+class UpdateQueue {
+  static_assert(T_CAPACITY >= 2 && T_CAPACITY <= 128
+      && (T_CAPACITY & (T_CAPACITY - 1)) == 0,
+      "T_CAPACITY must be a power of 2 in the range [2, 128]");
+
+  public:
+    /** Constructor. The queue starts empty. */
+    UpdateQueue() : mReadIndex(0), mWriteIndex(0) {}
+
+    //-----------------------------------------------------------------------
+    // Producer methods.
+    //-----------------------------------------------------------------------
+
+    /**
+     * Enqueue a LedModule::setPatternAt(). Return false if the queue is full.
+     */
+    bool setPatternAt(uint8_t pos, uint8_t pattern) {
+      uint8_t writeIndex = mWriteIndex;
+      if (getFreeSlots(writeIndex) < 1) return false;
+
+      writeCommand(writeIndex++, kCommandPattern, pos, pattern);
+      __atomic_store_n(&mWriteIndex, writeIndex, __ATOMIC_RELEASE);
+      return true;
+    }
+
+    /**
+     * Enqueue a LedModule::setBrightness(). Return false if the queue is full.
+     */
+    bool setBrightness(uint8_t brightness) {
+      uint8_t writeIndex = mWriteIndex;
+      if (getFreeSlots(writeIndex) < 1) return false;
+
+      writeCommand(writeIndex++, kCommandBrightness, 0, brightness);
+      __atomic_store_n(&mWriteIndex, writeIndex, __ATOMIC_RELEASE);
+      return true;
+    }
+
+    /**
+     * Enqueue the patterns of `len` consecutive digits starting at `pos`, as a
+     * single update which is applied all at once. Return false, and enqueue
+     * nothing, if the queue does not have room for all of them.
+     */
+    bool setPatterns(uint8_t pos, const uint8_t patterns[], uint8_t len) {
+      uint8_t writeIndex = mWriteIndex;
+      if (getFreeSlots(writeIndex) < len) return false;
+
+      for (uint8_t i = 0; i < len; ++i) {
+        writeCommand(writeIndex++, kCommandPattern, pos + i, patterns[i]);
+      }
+      __atomic_store_n(&mWriteIndex, writeIndex, __ATOMIC_RELEASE);
+      return true;
+    }
+
+    //-----------------------------------------------------------------------
+    // Consumer methods.
+    //-----------------------------------------------------------------------
+
+    /** Return true if there are no commands waiting to be applied. */
+    bool isEmpty() const {
+      return __atomic_load_n(&mWriteIndex, __ATOMIC_ACQUIRE) == mReadIndex;
+    }
+
+    /**
+     * Apply the commands which are in the queue at the time of the call to
+     * `module`, in the order that they were enqueued, and return the number of
+     * commands applied. Commands enqueued while this is running are left for
+     * the next call, so the time spent here is bounded by T_CAPACITY.
+     *
+     * @tparam T_LED_MODULE an LedModule, or any class with setPatternAt() and
+     *    setBrightness() methods
+     */
+    template <typename T_LED_MODULE>
+    uint8_t apply(T_LED_MODULE& module) {
+      const uint8_t writeIndex =
+          __atomic_load_n(&mWriteIndex, __ATOMIC_ACQUIRE);
+      uint8_t readIndex = mReadIndex;
+      const uint8_t count = writeIndex - readIndex;
+
+      for (; readIndex != writeIndex; ++readIndex) {
+        const Command& command = mCommands[readIndex & kIndexMask];
+        if (command.type == kCommandPattern) {
+          module.setPatternAt(command.pos, command.value);
+        } else {
+          module.setBrightness(command.value);
+        }
+      }
+      __atomic_store_n(&mReadIndex, readIndex, __ATOMIC_RELEASE);
+      return count;
+    }
+
+  private:
+    /** Type of a command. */
+    static uint8_t const kCommandPattern = 0;
+    static uint8_t const kCommandBrightness = 1;
+
+    /** Converts a free-running index into an index of mCommands. */
+    static uint8_t const kIndexMask = T_CAPACITY - 1;
+
+    /** An update of the LedModule. */
+    struct Command {
+      uint8_t type;
+      uint8_t pos;
+      uint8_t value;
+    };
+
+    /** Number of free slots, as seen by the producer. */
+    uint8_t getFreeSlots(uint8_t writeIndex) const {
+      const uint8_t readIndex = __atomic_load_n(&mReadIndex, __ATOMIC_ACQUIRE);
+      return T_CAPACITY - (uint8_t) (writeIndex - readIndex);
+    }
+
+    /** Fill in the slot at `index`, which is not yet visible to the consumer. */
+    void writeCommand(uint8_t index, uint8_t type, uint8_t pos, uint8_t value) {
+      Command& command = mCommands[index & kIndexMask];
+      command.type = type;
+      command.pos = pos;
+      command.value = value;
+    }
+
+  private:
+    Command mCommands[T_CAPACITY];
+
+    /** Index of the next command to apply. Written only by the consumer. */
+    uint8_t mReadIndex;
+
+    /** Index of the next free slot. Written only by the producer. */
+    uint8_t mWriteIndex;
+};
+
+} // ace_segment
+
+#endif
@@ -0,0 +1,198 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_FRAME_RATE_GOVERNOR_H
+#define ACE_SEGMENT_FRAME_RATE_GOVERNOR_H
+
+#include <stdint.h>
+#include "../hw/ClockInterface.h" // ClockInterface
+
+namespace ace_segment {
+
+/**
+ * A replacement for ScanningModule::renderFieldWhenReady() which adapts the
+ * frame rate of the module to the load of the application. The lateness of
+ * each field (the delay between the time the field was due and the time
+ * renderFieldWhenReady() was actually called) is averaged over a window of
+ * kFramesPerWindow frames.
+ *
+ * If the average lateness of a window is greater than 1/4 of the field period,
+ * the loop() is too busy to keep up, and the frame rate is lowered by
+ * `stepFps`, so that the fields are rendered at a slower but regular rate. If
+ * the average lateness stays below 1/16 of the field period for kRaiseWindows
+ * consecutive windows, the frame rate is raised by `stepFps`. The frame rate
+ * stays within `[minFps, maxFps]`.
+ *
+ * @tparam T_MODULE the ScanningModule (or a subclass like Hc595Module)
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()). The default is ClockInterface.
+ */
+template <typename T_MODULE, typename T_CI = ClockInterface>
+class FrameRateGovernor {
+  public:
+    /** Number of frames in each measurement window. */
+    static const uint8_t kFramesPerWindow = 8;
+
+    /** Number of consecutive idle windows before the frame rate is raised. */
+    static const uint8_t kRaiseWindows = 4;
+
+    /**
+     * Constructor.
+     *
+     * @param module the scanning module
+     * @param minFps lowest frame rate, which should be above the flicker
+     *    threshold
+     * @param maxFps highest frame rate, used when the application is idle
+     * @param stepFps amount of each change of the frame rate
+     */
+    explicit FrameRateGovernor(
+        T_MODULE& module,
+        uint8_t minFps,
+        uint8_t maxFps,
+        uint8_t stepFps = 5
+    ) :
+        mModule(module),
+        mMinFps(minFps),
+        mMaxFps(maxFps),
+        mStepFps(stepFps)
+    {}
+
+    /**
+     * Set the frame rate of the module to maxFps and reset the measurements.
+     * The module must be initialized separately, before this is called.
+     */
+    void begin() {
+      mModule.setFramesPerSecond(mMaxFps);
+      mAchievedFps = 0;
+      mAverageLatenessMicros = 0;
+      mIdleWindows = 0;
+      uint32_t now = T_CI::micros();
+      mNextFieldMicros = now + mModule.getMicrosPerField();
+      startWindow(now);
+    }
+
+    /**
+     * Render the next field if it is due. Call this from the global loop()
+     * instead of ScanningModule::renderFieldWhenReady().
+     *
+     * @return true if the field was rendered
+     */
+    bool renderFieldWhenReady() {
+      uint32_t now = T_CI::micros();
+      int32_t lateness = (int32_t) (now - mNextFieldMicros);
+      if (lateness < 0) return false;
+
+      mModule.renderFieldNow();
+      mNextFieldMicros = now + mModule.getMicrosPerField();
+      mSumLatenessMicros += lateness;
+      mNumFields++;
+
+      if (mNumFields >= kFramesPerWindow * mModule.getFieldsPerFrame()) {
+        endWindow(now);
+      }
+      return true;
+    }
+
+    /** Return the frame rate currently requested from the module. */
+    uint8_t getFramesPerSecond() const { return mModule.getFramesPerSecond(); }
+
+    /**
+     * Return the frame rate measured over the previous window. Returns 0 until
+     * the first window is complete.
+     */
+    uint16_t getAchievedFramesPerSecond() const { return mAchievedFps; }
+
+    /** Return the average lateness of the fields of the previous window. */
+    uint16_t getAverageLatenessMicros() const {
+      return mAverageLatenessMicros;
+    }
+
+  private:
+    void startWindow(uint32_t now) {
+      mWindowStartMicros = now;
+      mSumLatenessMicros = 0;
+      mNumFields = 0;
+    }
+
+    /** Update the measurements, and adjust the frame rate if necessary. */
+    void endWindow(uint32_t now) {
+      uint32_t elapsed = now - mWindowStartMicros;
+      uint32_t frameMicros = elapsed / kFramesPerWindow;
+      mAchievedFps = (frameMicros == 0) ? 0 : 1000000UL / frameMicros;
+      uint32_t lateness = mSumLatenessMicros / mNumFields;
+      mAverageLatenessMicros = (lateness > UINT16_MAX) ? UINT16_MAX : lateness;
+
+      uint16_t fieldMicros = mModule.getMicrosPerField();
+      uint8_t fps = mModule.getFramesPerSecond();
+      if (mAverageLatenessMicros > fieldMicros / 4) {
+        mIdleWindows = 0;
+        fps = (fps > mMinFps + mStepFps) ? fps - mStepFps : mMinFps;
+      } else if (mAverageLatenessMicros < fieldMicros / 16) {
+        if (++mIdleWindows >= kRaiseWindows) {
+          mIdleWindows = 0;
+          fps = (fps + mStepFps < mMaxFps) ? fps + mStepFps : mMaxFps;
+        }
+      } else {
+        mIdleWindows = 0;
+      }
+
+      if (fps != mModule.getFramesPerSecond()) {
+        mModule.setFramesPerSecond(fps);
+      }
+      startWindow(now);
+    }
+
+    // disable copy-constructor and assignment operator
+    FrameRateGovernor(const FrameRateGovernor&) = delete;
+    FrameRateGovernor& operator=(const FrameRateGovernor&) = delete;
+
+  private:
+    T_MODULE& mModule;
+
+    /** Time when the next field is due. */
+    uint32_t mNextFieldMicros;
+
+    /** Start of the current measurement window. */
+    uint32_t mWindowStartMicros;
+
+    /** Sum of the lateness of the fields in the current window. */
+    uint32_t mSumLatenessMicros;
+
+    /** Number of fields rendered in the current window. */
+    uint16_t mNumFields;
+
+    uint16_t mAchievedFps;
+    uint16_t mAverageLatenessMicros;
+
+    uint8_t const mMinFps;
+    uint8_t const mMaxFps;
+    uint8_t const mStepFps;
+
+    /** Number of consecutive windows with little lateness. */
+    uint8_t mIdleWindows;
+};
+
+}
+
+#endif
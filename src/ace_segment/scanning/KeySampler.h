@@ -0,0 +1,126 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_KEY_SAMPLER_H
+#define ACE_SEGMENT_KEY_SAMPLER_H
+
+#include <stdint.h>
+#include <Arduino.h> // INPUT, INPUT_PULLUP
+
+namespace ace_segment {
+namespace internal {
+
+/**
+ * Samples the key-return pin of a key matrix which shares the group pins of
+ * an LedMatrix, one key per group. Used as an empty base class by
+ * LedMatrixDirect and LedMatrixSingleHc595, so that the pin, the state and the
+ * extra branch in draw() exist only if T_KEYS is true.
+ *
+ * @tparam T_GPIOI class that provides access to the GPIO pins
+ * @tparam T_KEYS true if a key matrix is wired to the group pins
+ */
+template <typename T_GPIOI, bool T_KEYS>
+class KeySampler {
+  protected:
+    explicit KeySampler(uint8_t keyPin) : mKeyPin(keyPin) {}
+
+    /**
+     * The key-return pin idles at the inactive level of the group pins, given
+     * by groupOffOutput, using the internal pull-up if that level is HIGH,
+     * otherwise an external pull-down resistor is required.
+     */
+    void beginKeyPin(uint8_t groupOffOutput) const {
+      T_GPIOI::pinMode(mKeyPin, groupOffOutput ? INPUT_PULLUP : INPUT);
+    }
+
+    void endKeyPin() const {
+      T_GPIOI::pinMode(mKeyPin, INPUT);
+    }
+
+    /** Record whether the previous group is still enabled. */
+    void setKeyGroupEnabled(bool isEnabled) const {
+      mIsGroupEnabled = isEnabled;
+    }
+
+    /**
+     * Sample the key-return pin while the previous group is still enabled,
+     * just before the next draw() changes it, so that the line has settled
+     * for a full field. A pressed key pulls the key-return pin to the active
+     * level of its group pin. This adds a read, but no pin transitions.
+     */
+    void sampleKey(uint8_t group, uint8_t groupXorMask) const {
+      if (! mIsGroupEnabled) return;
+
+      const uint16_t groupBit = (uint16_t) 0x1 << group;
+      if ((T_GPIOI::digitalRead(mKeyPin) ^ groupXorMask) & 0x1) {
+        mKeyBits |= groupBit;
+      } else {
+        mKeyBits &= ~groupBit;
+      }
+    }
+
+    /**
+     * Return the sampled keys. The draw() is usually called from an ISR, which
+     * can update mKeyBits between the reads of its 2 bytes on an 8-bit
+     * processor, so read it until two reads agree.
+     */
+    uint16_t readKeyBits() const {
+      uint16_t keyBits;
+      do {
+        keyBits = mKeyBits;
+      } while (keyBits != mKeyBits);
+      return keyBits;
+    }
+
+  private:
+    uint8_t const mKeyPin;
+
+    /** True if the previous group is still enabled, so its key can be read. */
+    mutable bool mIsGroupEnabled = false;
+
+    /** Sampled state of the key of each group, 1 meaning pressed. */
+    mutable volatile uint16_t mKeyBits = 0;
+};
+
+/** Without a key matrix, nothing is stored and nothing is sampled. */
+template <typename T_GPIOI>
+class KeySampler<T_GPIOI, false> {
+  protected:
+    explicit KeySampler(uint8_t /*keyPin*/) {}
+
+    void beginKeyPin(uint8_t /*groupOffOutput*/) const {}
+
+    void endKeyPin() const {}
+
+    void setKeyGroupEnabled(bool /*isEnabled*/) const {}
+
+    void sampleKey(uint8_t /*group*/, uint8_t /*groupXorMask*/) const {}
+
+    uint16_t readKeyBits() const { return 0; }
+};
+
+} // internal
+} // ace_segment
+
+#endif
@@ -33,6 +33,9 @@ static const uint8_t kActiveHighPattern = 0xFF;
 /** Bit pattern to indicate that logical 0 activates group or element. */
 static const uint8_t kActiveLowPattern = 0x00;
 
+/** Pin number which indicates that no key-return pin is wired. */
+static const uint8_t kNoKeyPin = 255;
+
 /**
  * Class that represents the abstraction of a particular LED display wiring, and
  * knows how to turn off and turn on a specific group of LEDs with a specific
@@ -41,7 +44,7 @@ static const uint8_t kActiveLowPattern = 0x00;
  * (However, an implementation class may need to cache a small bit of
  * information to implement this API abstraction.)
  *
- * I have provided 3 wiring implementations:
+ * I have provided 4 wiring implementations:
  *
  *  * LedMatrixDirect
  *      * The element and group pins are directly attached to GPIO pins
@@ -53,14 +56,18 @@ static const uint8_t kActiveLowPattern = 0x00;
  *  * LedMatrixDualHc595
  *    * Both the element and group pins are controlled by 74HC595 chips
  *      using SPI (software or hardware).
+ *  * LedMatrixDualBankHc595
+ *    * Two banks of groups with separate element pins, controlled by three
+ *      74HC595 chips, for the kScanDualBank mode of ScanningModule.
  *
  * In most cases, the resistors will be on the segments to control the current
  * on each segment, so the segments become elements and the digits become the
  * groups.
  *
  * If the resistors are on the digits, then the digits become the elements and
- * the segments become the groups. This configuration is not very useful and has
- * not been tested very much.
+ * the segments become the groups. This configuration is used by the
+ * kScanSegmentMajor mode of ScanningModule. The implementation classes do not
+ * depend on the orientation.
  *
  * The elementOnPattern and groupOnPattern are the bit patterns that activate
  * the element and group. For example, a Common Cathode LED module places the
@@ -109,6 +116,26 @@ class LedMatrixBase {
     /** Clear everything. */
     void clear() const {}
 
+    /**
+     * True if setBrightness() controls the brightness in hardware, so that a
+     * brightness of 0 turns off all elements.
+     */
+    static const bool kHasBrightness = false;
+
+    /**
+     * Set the global brightness (0-255) using hardware on the LED matrix, such
+     * as a PWM signal on the output enable pin of a 74HC595. Most wirings have
+     * no such hardware, so the default does nothing.
+     */
+    void setBrightness(uint8_t /*brightness*/) const {}
+
+    /**
+     * Return the state of the keys wired between the groups and a key-return
+     * pin, one bit per group (1 meaning pressed), sampled while each group was
+     * enabled. Most wirings have no keys, so the default returns 0.
+     */
+    uint16_t getKeyBits() const { return 0; }
+
   protected:
     uint8_t const mElementXorMask;
     uint8_t const mGroupXorMask;
@@ -28,6 +28,7 @@ SOFTWARE.
 #include <Arduino.h> // OUTPUT, INPUT
 #include "../hw/GpioInterface.h"
 #include "LedMatrixBase.h"
+#include "KeySampler.h"
 
 class LedMatrixDirectTest_drawElements;
 
@@ -39,9 +40,14 @@ namespace ace_segment {
  *
  * @tparam T_GPIOI (optional) class that provides access to the GPIO pins,
  *    default is GpioInterface (note: 'GPI' is already taken on ESP8266)
+ * @tparam T_KEYS (optional) true if a key matrix shares the group pins, one
+ *    key per group, read through the keyPin given to the constructor.
+ *    Default false, which removes the key sampling from draw().
  */
-template <typename T_GPIOI = GpioInterface>
-class LedMatrixDirect : public LedMatrixBase {
+template <typename T_GPIOI = GpioInterface, bool T_KEYS = false>
+class LedMatrixDirect :
+    public LedMatrixBase,
+    private internal::KeySampler<T_GPIOI, T_KEYS> {
   public:
     /**
      * Constructor.
@@ -51,6 +57,8 @@ class LedMatrixDirect : public LedMatrixBase {
      * @param elementPins pointer to array of 'numElements' pin numbers
      * @param numGroups number of LED groups (digits)
      * @param groupPins pointer to array of 'numGroups' pin numbers
+     * @param keyPin (optional) key-return pin of the key matrix, used only if
+     *    T_KEYS is true, default kNoKeyPin
      */
     LedMatrixDirect(
         uint8_t elementOnPattern,
@@ -58,9 +66,11 @@ class LedMatrixDirect : public LedMatrixBase {
         uint8_t numElements,
         const uint8_t* elementPins,
         uint8_t numGroups,
-        const uint8_t* groupPins
+        const uint8_t* groupPins,
+        uint8_t keyPin = kNoKeyPin
     ) :
         LedMatrixBase(elementOnPattern, groupOnPattern),
+        internal::KeySampler<T_GPIOI, T_KEYS>(keyPin),
         mElementPins(elementPins),
         mGroupPins(groupPins),
         mNumElements(numElements),
@@ -83,6 +93,8 @@ class LedMatrixDirect : public LedMatrixBase {
         T_GPIOI::pinMode(pin, OUTPUT);
         T_GPIOI::digitalWrite(pin, output);
       }
+
+      this->beginKeyPin(output);
     }
 
     void end() const {
@@ -97,9 +109,12 @@ class LedMatrixDirect : public LedMatrixBase {
         uint8_t pin = mGroupPins[group];
         T_GPIOI::pinMode(pin, INPUT);
       }
+
+      this->endKeyPin();
     }
 
     void draw(uint8_t group, uint8_t elementPattern) const {
+      this->sampleKey(mPrevGroup, mGroupXorMask);
       if (group != mPrevGroup) {
         disableGroup(mPrevGroup);
       }
@@ -112,13 +127,22 @@ class LedMatrixDirect : public LedMatrixBase {
     void enableGroup(uint8_t group) const {
       writeGroupPin(group, 0x1);
       mPrevGroup = group;
+      this->setKeyGroupEnabled(true);
     }
 
     void disableGroup(uint8_t group) const {
       writeGroupPin(group, 0x0);
       mPrevGroup = group;
+      this->setKeyGroupEnabled(false);
     }
 
+    /**
+     * Return the keys sampled on the key-return pin, one bit per group, 1
+     * meaning pressed. Each bit is updated when its group is scanned. Only the
+     * first 16 groups are supported. Always 0 if T_KEYS is false.
+     */
+    uint16_t getKeyBits() const { return this->readKeyBits(); }
+
     void clear() const {
       for (uint8_t group = 0; group < mNumGroups; group++) {
         disableGroup(group);
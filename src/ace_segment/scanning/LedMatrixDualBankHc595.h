@@ -0,0 +1,170 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_LED_MATRIX_DUAL_BANK_HC595_H
+#define ACE_SEGMENT_LED_MATRIX_DUAL_BANK_HC595_H
+
+#include "LedMatrixBase.h"
+
+namespace ace_segment {
+
+/**
+ * An LedMatrix for a display whose digits are split into 2 banks (A and B),
+ * each with its own segment (element) bus, so that one digit of each bank can
+ * be lit at the same time. Three 74HC595 shift registers are daisy chained:
+ * the group pins of both banks on one chip, the element pins of bank B on the
+ * second, and the element pins of bank A on the third, so that both banks are
+ * updated in a single 24-bit transfer.
+ *
+ * The group pins of bank A are bits [0, groupsPerBank) of the group byte, and
+ * the group pins of bank B are bits [groupsPerBank, 2*groupsPerBank). The
+ * group byte is sent first, then the bank B elements, then the bank A
+ * elements.
+ *
+ * This class is used by ScanningModule in the kScanDualBank mode, which calls
+ * drawBanks() instead of draw(). The draw() method lights a single group, for
+ * compatibility with the other scanning modes.
+ *
+ * @tparam T_SPII class that implements the SPI interface, usually one of the
+ *    classes in the AceSPI library: SimpleSpiInterface, SimpleSpiFastInterface,
+ *    HardSpiInterface, HardSpiFastInterface.
+ */
+template <typename T_SPII>
+class LedMatrixDualBankHc595: public LedMatrixBase {
+  public:
+    /**
+     * Constructor.
+     * @param spiInterface object that knows how to send SPI packets
+     * @param elementOnPattern bit pattern that turns on the elements
+     * @param groupOnPattern bit pattern that turns on the groups
+     * @param groupsPerBank number of groups (digits) in each bank, at most 4
+     */
+    LedMatrixDualBankHc595(
+        const T_SPII& spiInterface,
+        uint8_t elementOnPattern,
+        uint8_t groupOnPattern,
+        uint8_t groupsPerBank
+    ) :
+        LedMatrixBase(elementOnPattern, groupOnPattern),
+        mSpiInterface(spiInterface),
+        mGroupsPerBank(groupsPerBank),
+        mPrevElementPatternA(0x00),
+        mPrevElementPatternB(0x00)
+    {}
+
+    void begin() const {}
+
+    void end() const {}
+
+    /**
+     * Light the given group of bank A with elementPatternA, and the same group
+     * of bank B with elementPatternB, in a single transfer.
+     *
+     * @param group the group within each bank, in [0, groupsPerBank)
+     */
+    void drawBanks(
+        uint8_t group,
+        uint8_t elementPatternA,
+        uint8_t elementPatternB
+    ) const {
+      uint8_t groupPattern = (0x1 << group) | (0x1 << (group + mGroupsPerBank));
+      drawPatterns(groupPattern, elementPatternA, elementPatternB);
+      mPrevElementPatternA = elementPatternA;
+      mPrevElementPatternB = elementPatternB;
+    }
+
+    /**
+     * Light a single group, numbered across both banks, i.e. [0,
+     * groupsPerBank) for bank A, then [groupsPerBank, 2*groupsPerBank) for
+     * bank B.
+     */
+    void draw(uint8_t group, uint8_t elementPattern) const {
+      uint8_t groupPattern = 0x1 << group;
+      if (group < mGroupsPerBank) {
+        drawPatterns(groupPattern, elementPattern, 0x00);
+        mPrevElementPatternA = elementPattern;
+        mPrevElementPatternB = 0x00;
+      } else {
+        drawPatterns(groupPattern, 0x00, elementPattern);
+        mPrevElementPatternA = 0x00;
+        mPrevElementPatternB = elementPattern;
+      }
+    }
+
+    /** Turn on the given group of both banks, using the previous patterns. */
+    void enableGroup(uint8_t group) const {
+      drawBanks(group, mPrevElementPatternA, mPrevElementPatternB);
+    }
+
+    /** Turn off the given group of both banks. */
+    void disableGroup(uint8_t group) const {
+      (void) group;
+      drawPatterns(0x00, 0x00, 0x00);
+    }
+
+    /** Clear the entire display. */
+    void clear() const {
+      drawPatterns(0x00, 0x00, 0x00);
+      mPrevElementPatternA = 0x00;
+      mPrevElementPatternB = 0x00;
+    }
+
+  private:
+    /**
+     * Send the group pattern and the element patterns of both banks in one
+     * transaction, inverting them if necessary due to wiring requirements.
+     */
+    void drawPatterns(
+        uint8_t groupPattern,
+        uint8_t elementPatternA,
+        uint8_t elementPatternB
+    ) const {
+      mSpiInterface.beginTransaction();
+      mSpiInterface.transfer(groupPattern ^ mGroupXorMask);
+      mSpiInterface.transfer(elementPatternB ^ mElementXorMask);
+      mSpiInterface.transfer(elementPatternA ^ mElementXorMask);
+      mSpiInterface.endTransaction();
+    }
+
+  private:
+    /**
+     * SPI interface object. Copied by value instead of reference to avoid an
+     * extra level of indirection.
+     */
+    const T_SPII mSpiInterface;
+
+    /** Number of groups in each bank. */
+    const uint8_t mGroupsPerBank;
+
+    /**
+     * Remember the previous element patterns to support disableGroup() and
+     * enableGroup().
+     */
+    mutable uint8_t mPrevElementPatternA;
+    mutable uint8_t mPrevElementPatternB;
+};
+
+}
+
+#endif
@@ -25,6 +25,8 @@ SOFTWARE.
 #ifndef ACE_SEGMENT_LED_MATRIX_DUAL_HC595_H
 #define ACE_SEGMENT_LED_MATRIX_DUAL_HC595_H
 
+#include "../hw/PwmInterface.h"
+#include "../hw/remap.h"
 #include "LedMatrixBase.h"
 
 class LedMatrixDualHc595Test_draw;
@@ -51,12 +53,27 @@ const uint8_t kByteOrderElementHighGroupLow = 1;
  * @tparam T_SPII class that implements the SPI interface, usually one of the
  *    classes in the AceSPI library: SimpleSpiInterface, SimpleSpiFastInterface,
  *    HardSpiInterface, HardSpiFastInterface.
+ * @tparam T_PWMI (optional) class that writes a PWM duty cycle to the output
+ *    enable (OE) pin of the 74HC595 chips to control the global brightness in
+ *    hardware, usually PwmInterface. The default is NullPwmInterface which
+ *    leaves the OE pin alone.
+ * @tparam T_REMAP (optional) class that maps the physical positions to their
+ *    logical positions: RemapArray (default) which uses the
+ *    remapArrayInverted given to the constructor, or the Inverse of a
+ *    RemapSequence fixed at compile-time.
  */
-template <typename T_SPII>
-class LedMatrixDualHc595: public LedMatrixBase {
+template <
+    typename T_SPII,
+    typename T_PWMI = NullPwmInterface,
+    typename T_REMAP = RemapArray>
+class LedMatrixDualHc595: public LedMatrixBase, private T_REMAP {
   public:
+    /** The OE pin controls the brightness, unless T_PWMI is a no-op. */
+    static const bool kHasBrightness = T_PWMI::kEnabled;
+
     /**
-     * Constructor.
+     * Constructor without the OE pin, available only if T_PWMI is a no-op
+     * (e.g. NullPwmInterface).
      * @param spiInterface object that knows how to send SPI packets
      * @param elementOnPattern bit pattern that turns on the elements
      * @param groupOnpattern bit pattern that turns on the groups
@@ -70,17 +87,53 @@ class LedMatrixDualHc595: public LedMatrixBase {
         uint8_t elementOnPattern,
         uint8_t groupOnPattern,
         uint8_t byteOrder,
-        const uint8_t* remapArrayInverted = nullptr
+        typename T_REMAP::Argument remapArrayInverted = nullptr
+    ) :
+        LedMatrixDualHc595(
+            spiInterface,
+            elementOnPattern,
+            groupOnPattern,
+            byteOrder,
+            remapArrayInverted,
+            0 /*outputEnablePin*/)
+    {
+      static_assert(! T_PWMI::kEnabled,
+          "outputEnablePin is required if T_PWMI is enabled");
+    }
+
+    /**
+     * Constructor with the OE pin, required if T_PWMI is enabled.
+     * @param spiInterface object that knows how to send SPI packets
+     * @param elementOnPattern bit pattern that turns on the elements
+     * @param groupOnpattern bit pattern that turns on the groups
+     * @param byteOrder determine order of group and element bytes
+     * @param remapArrayInverted (nullable) a map of the physical positions to
+     *    their logical positions, which is the inverse of the remapArray used
+     *    by Tm1637Module and Max7219Module
+     * @param outputEnablePin PWM-capable pin wired to the active-low OE pin of
+     *    the 74HC595 chips, ignored if T_PWMI is NullPwmInterface
+     */
+    LedMatrixDualHc595(
+        const T_SPII& spiInterface,
+        uint8_t elementOnPattern,
+        uint8_t groupOnPattern,
+        uint8_t byteOrder,
+        typename T_REMAP::Argument remapArrayInverted,
+        uint8_t outputEnablePin
     ) :
         LedMatrixBase(elementOnPattern, groupOnPattern),
+        T_REMAP(remapArrayInverted),
         mSpiInterface(spiInterface),
-        mRemapArrayInverted(remapArrayInverted),
-        mByteOrder(byteOrder)
+        mByteOrder(byteOrder),
+        mOutputEnablePin(outputEnablePin)
     {}
 
     void begin() const {}
 
-    void end() const {}
+    /** Disable the outputs of the 74HC595 chips through the OE pin. */
+    void end() const {
+      T_PWMI::analogWrite(mOutputEnablePin, 255);
+    }
 
     /**
      * Write out the group and element patterns in a single 16-bit stream.
@@ -137,6 +190,15 @@ class LedMatrixDualHc595: public LedMatrixBase {
       mPrevElementPattern = 0x00;
     }
 
+    /**
+     * Set the global brightness by writing a PWM duty cycle to the OE pin. The
+     * OE pin is active-low, so the duty cycle is inverted. This gives 256
+     * brightness levels without the subfield modulation of ScanningModule.
+     */
+    void setBrightness(uint8_t brightness) const {
+      T_PWMI::analogWrite(mOutputEnablePin, 255 - brightness);
+    }
+
   private:
     /**
      * Send the groupPattern and elementPattern to the display  through SPI. The
@@ -155,7 +217,7 @@ class LedMatrixDualHc595: public LedMatrixBase {
 
     /** Convert a logical position into its physical position. */
     uint8_t remapPhysicalToLogical(uint8_t pos) const {
-      return mRemapArrayInverted ? mRemapArrayInverted[pos] : pos;
+      return T_REMAP::remap(pos);
     }
 
   private:
@@ -169,15 +231,12 @@ class LedMatrixDualHc595: public LedMatrixBase {
      */
     const T_SPII mSpiInterface;
 
-    /**
-     * Mapping of the physical-to-logical addresses, which is the inverse of the
-     * mapping needed by Tm1637Module and Max7219Module.
-     */
-    const uint8_t* const mRemapArrayInverted;
-
     /** Determine order of group and element bytes. */
     const uint8_t mByteOrder;
 
+    /** The PWM pin wired to the OE pin of the 74HC595 chips. */
+    const uint8_t mOutputEnablePin;
+
     /**
      * Remember the previous element pattern to support disableGroup() and
      * enableGroup().
@@ -28,6 +28,7 @@ SOFTWARE.
 #include <Arduino.h> // OUTPUT, INPUT
 #include "../hw/GpioInterface.h"
 #include "LedMatrixBase.h"
+#include "KeySampler.h"
 
 class LedMatrixSingleHc595Test_drawElements;
 
@@ -48,9 +49,18 @@ namespace ace_segment {
  *    HardSpiInterface, HardSpiFastInterface.
  * @tparam T_GPIOI (optional) interface to GPIO functions,
  *    default GpioInterface (note: 'GPI' is already taken on ESP8266)
+ * @tparam T_KEYS (optional) true if a key matrix shares the group pins, one
+ *    key per group, read through the keyPin given to the constructor.
+ *    Default false, which removes the key sampling from draw().
  */
-template <typename T_SPII, typename T_GPIOI = GpioInterface>
-class LedMatrixSingleHc595 : public LedMatrixBase {
+template <
+    typename T_SPII,
+    typename T_GPIOI = GpioInterface,
+    bool T_KEYS = false
+>
+class LedMatrixSingleHc595 :
+    public LedMatrixBase,
+    private internal::KeySampler<T_GPIOI, T_KEYS> {
   public:
     /**
      * Constructor.
@@ -59,15 +69,19 @@ class LedMatrixSingleHc595 : public LedMatrixBase {
      * @param groupOnpattern bit pattern that turns on the groups (digits)
      * @param numGroups number of LED groups (digits)
      * @param groupPins pointer to array of 'numGroups' pin numbers
+     * @param keyPin (optional) key-return pin of the key matrix, used only if
+     *    T_KEYS is true, default kNoKeyPin
      */
     LedMatrixSingleHc595(
         const T_SPII& spiInterface,
         uint8_t elementOnPattern,
         uint8_t groupOnPattern,
         uint8_t numGroups,
-        const uint8_t* groupPins
+        const uint8_t* groupPins,
+        uint8_t keyPin = kNoKeyPin
     ) :
         LedMatrixBase(elementOnPattern, groupOnPattern),
+        internal::KeySampler<T_GPIOI, T_KEYS>(keyPin),
         mSpiInterface(spiInterface),
         mGroupPins(groupPins),
         mNumGroups(numGroups)
@@ -81,6 +95,8 @@ class LedMatrixSingleHc595 : public LedMatrixBase {
         T_GPIOI::pinMode(pin, OUTPUT);
         T_GPIOI::digitalWrite(pin, output);
       }
+
+      this->beginKeyPin(output);
     }
 
     void end() const {
@@ -89,9 +105,12 @@ class LedMatrixSingleHc595 : public LedMatrixBase {
         uint8_t pin = mGroupPins[group];
         T_GPIOI::pinMode(pin, INPUT);
       }
+
+      this->endKeyPin();
     }
 
     void draw(uint8_t group, uint8_t elementPattern) const {
+      this->sampleKey(mPrevGroup, mGroupXorMask);
       if (group != mPrevGroup) {
         disableGroup(mPrevGroup);
       }
@@ -104,13 +123,22 @@ class LedMatrixSingleHc595 : public LedMatrixBase {
     void enableGroup(uint8_t group) const {
       writeGroupPin(group, 0x1);
       mPrevGroup = group;
+      this->setKeyGroupEnabled(true);
     }
 
     void disableGroup(uint8_t group) const {
       writeGroupPin(group, 0x0);
       mPrevGroup = group;
+      this->setKeyGroupEnabled(false);
     }
 
+    /**
+     * Return the keys sampled on the key-return pin, one bit per group, 1
+     * meaning pressed. Each bit is updated when its group is scanned. Only the
+     * first 16 groups are supported. Always 0 if T_KEYS is false.
+     */
+    uint16_t getKeyBits() const { return this->readKeyBits(); }
+
     void clear() const {
       for (uint8_t group = 0; group < mNumGroups; group++) {
         disableGroup(group);
@@ -30,12 +30,333 @@ SOFTWARE.
 #include <AceCommon.h> // incrementMod()
 #include "../hw/ClockInterface.h" // ClockInterface
 #include "../LedModule.h"
+#include "scan_order.h"
 
 class ScanningModuleTest_isAnyDigitDirty;
 class ScanningModuleTest_isBrightnessDirty;
+class ScanningModuleTest_segmentMajor;
+class ScanningModuleTest_dithering;
 
 namespace ace_segment {
 
+/**
+ * Scan one digit at a time, driving the segment pattern of that digit. Each
+ * digit is lit 1/T_DIGITS of the time. This is the default.
+ */
+static const uint8_t kScanDigitMajor = 0;
+
+/**
+ * Scan one segment at a time, driving that segment on all digits. Each LED is
+ * lit 1/8 of the time, independent of the number of digits. The LedMatrixBase
+ * must be wired with the digits as the elements and the segments as the
+ * groups. Supports at most 8 digits.
+ */
+static const uint8_t kScanSegmentMajor = 1;
+
+/**
+ * Scan one digit at a time like kScanDigitMajor, but remove the digits whose
+ * pattern is 0 from the rotation. The scan set is recomputed at the start of a
+ * frame, only if a digit is dirty. The use of the freed fields is selected by
+ * ScanningModule::setBlankPolicy().
+ */
+static const uint8_t kScanSkipBlankDigits = 2;
+
+/**
+ * Scan 2 banks of T_DIGITS/2 digits in parallel, lighting digit `i` of the
+ * first bank and digit `i + T_DIGITS/2` of the second bank in the same field.
+ * This halves the number of fields per frame, and doubles the duty cycle of
+ * each digit. The LedMatrix must provide a `drawBanks(group, elementPatternA,
+ * elementPatternB)` method, e.g. LedMatrixDualBankHc595. T_DIGITS must be
+ * even.
+ */
+static const uint8_t kScanDualBank = 3;
+
+/**
+ * Keep the field period, so the lit digits are scanned more often. Each lit
+ * digit is on 1/N of the time instead of 1/T_DIGITS, where N is the number of
+ * lit digits, so they become brighter and draw more power. This is the
+ * default.
+ */
+static const uint8_t kBlankPolicyBrighter = 0;
+
+/**
+ * Lengthen the field period so that the frame rate stays constant, reducing
+ * the number of calls to renderFieldNow(). The lit digits become brighter as
+ * with kBlankPolicyBrighter. The period is recomputed at the start of the frame
+ * which picks up the new scan set, and a ScanningTimer reprograms its timer
+ * after that field.
+ */
+static const uint8_t kBlankPolicyLowerRate = 1;
+
+/**
+ * Keep the field period, and scale the PWM brightness of the lit digits by
+ * N/T_DIGITS, so that the brightness and power of each digit stay constant
+ * while the frame rate increases. Requires T_SUBFIELDS > 1, otherwise it is
+ * the same as kBlankPolicyBrighter.
+ */
+static const uint8_t kBlankPolicyConstantBrightness = 2;
+
+/**
+ * Scan the digits (or segments) and subfields in sequence. This is the
+ * default.
+ */
+static const uint8_t kScanOrderSequential = 0;
+
+/**
+ * Scan the even digits (or segments) first, then the odd ones, e.g. "0 2 1 3",
+ * so that adjacent digits are lit about half a frame apart. This makes the
+ * flicker of a low frame rate less visible as a rolling pattern.
+ */
+static const uint8_t kScanOrderInterleaved = 0x1;
+
+/**
+ * Scan all digits once per subfield instead of scanning all subfields of one
+ * digit, and visit the subfields in bit-reversed order, so that the on-time of
+ * a partially bright digit is spread across the frame instead of bunched at
+ * the start of its slot. Can be combined with kScanOrderInterleaved.
+ */
+static const uint8_t kScanOrderSpreadSubFields = 0x2;
+
+/**
+ * Wrapper for the T_LM template parameter of ScanningModule which embeds a copy
+ * of the LedMatrix inside the ScanningModule, instead of holding a reference
+ * to an instance owned by the caller. This saves the RAM of the reference, and
+ * removes the load of the reference on every renderFieldNow(). The convenience
+ * classes (e.g. DirectModule, Hc595Module) use this.
+ */
+template <typename T_LM>
+struct OwnedLedMatrix {};
+
+namespace internal {
+
+/** Storage of the LedMatrix in ScanningModule: a reference by default. */
+template <typename T_LM>
+struct LedMatrixStorage {
+  using LedMatrix = T_LM;
+  using Type = const T_LM&;
+};
+
+/** Storage of the LedMatrix in ScanningModule: an embedded instance. */
+template <typename T_LM>
+struct LedMatrixStorage<OwnedLedMatrix<T_LM>> {
+  using LedMatrix = T_LM;
+  using Type = const T_LM;
+};
+
+/**
+ * The current subfield, and the pattern currently drawn by the LedMatrix,
+ * used by ScanningModule only if T_SUBFIELDS > 1.
+ */
+template <bool T_MODULATED>
+class SubFieldState {
+  protected:
+    uint8_t getCurrentSubField() const { return mCurrentSubField; }
+
+    void setCurrentSubField(uint8_t subField) { mCurrentSubField = subField; }
+
+    uint8_t getDrawnPattern() const { return mPattern; }
+
+    void setDrawnPattern(uint8_t pattern) { mPattern = pattern; }
+
+  private:
+    /** Index of the subfield within the current digit (or frame). */
+    uint8_t mCurrentSubField;
+
+    /**
+     * The segment pattern that is currently displaying on the LED. Used to
+     * optimize the displayCurrentFieldModulated() method if the current
+     * pattern is the same as the previous pattern.
+     */
+    uint8_t mPattern;
+};
+
+/**
+ * Without modulation, there is always a single subfield, so the state is
+ * empty, and the empty base class optimization removes it from the
+ * ScanningModule.
+ */
+template <>
+class SubFieldState<false> {
+  protected:
+    uint8_t getCurrentSubField() const { return 0; }
+
+    void setCurrentSubField(uint8_t /*subField*/) {}
+
+    uint8_t getDrawnPattern() const { return 0; }
+
+    void setDrawnPattern(uint8_t /*pattern*/) {}
+};
+
+/**
+ * The brightness of each digit given to ScanningModule::setBrightnessAt(),
+ * packed 2 digits per byte if T_PACKED. Used only if T_SUBFIELDS > 1.
+ */
+template <bool T_MODULATED, uint8_t T_DIGITS, bool T_PACKED>
+class DigitBrightnessState {
+  protected:
+    uint8_t getDigitBrightness(uint8_t digit) const {
+      if (T_PACKED) {
+        const uint8_t slot = mBrightnesses[digit >> 1];
+        return (digit & 0x1) ? (slot >> 4) : (slot & 0x0F);
+      } else {
+        return mBrightnesses[digit];
+      }
+    }
+
+    void setDigitBrightness(uint8_t digit, uint8_t brightness) {
+      if (T_PACKED) {
+        uint8_t& slot = mBrightnesses[digit >> 1];
+        slot = (digit & 0x1)
+            ? (slot & 0x0F) | (brightness << 4)
+            : (slot & 0xF0) | brightness;
+      } else {
+        mBrightnesses[digit] = brightness;
+      }
+    }
+
+  private:
+    uint8_t mBrightnesses[T_PACKED ? (T_DIGITS + 1) / 2 : T_DIGITS];
+};
+
+/** Without modulation, the per-digit brightness is not stored. */
+template <uint8_t T_DIGITS, bool T_PACKED>
+class DigitBrightnessState<false, T_DIGITS, T_PACKED> {
+  protected:
+    uint8_t getDigitBrightness(uint8_t /*digit*/) const { return 0; }
+
+    void setDigitBrightness(uint8_t /*digit*/, uint8_t /*brightness*/) {}
+};
+
+/**
+ * Return true if the ScanningModule caches the subfield brightness of each
+ * digit once per frame. See ScanningModule::kCacheFrameBrightnesses.
+ */
+constexpr bool isFrameBrightnessCached(
+    uint8_t subFields, uint8_t ditherBits, uint8_t scanMode) {
+  return subFields > 1
+      && (ditherBits > 0
+          || ACE_SEGMENT_ENABLE_STYLER
+          || scanMode == kScanSkipBlankDigits);
+}
+
+/**
+ * The subfield brightness of each digit in the current frame in the upper
+ * bits, and its dithering accumulator in the lower bits. Used only if
+ * isFrameBrightnessCached().
+ */
+template <bool T_CACHED, uint8_t T_DIGITS>
+class FrameBrightnessState {
+  protected:
+    void clearFrameStates() {
+      memset(mFrameStates, 0, T_DIGITS);
+    }
+
+    uint8_t getFrameState(uint8_t digit) const { return mFrameStates[digit]; }
+
+    void setFrameState(uint8_t digit, uint8_t state) {
+      mFrameStates[digit] = state;
+    }
+
+  private:
+    uint8_t mFrameStates[T_DIGITS];
+};
+
+/** Without the cache, the frame brightness is the stored brightness. */
+template <uint8_t T_DIGITS>
+class FrameBrightnessState<false, T_DIGITS> {
+  protected:
+    void clearFrameStates() {}
+
+    uint8_t getFrameState(uint8_t /*digit*/) const { return 0; }
+
+    void setFrameState(uint8_t /*digit*/, uint8_t /*state*/) {}
+};
+
+/**
+ * The digit bit mask of each segment, transposed from the patterns of the
+ * digits. Used only in kScanSegmentMajor mode.
+ */
+template <bool T_SEGMENT_MAJOR>
+class SegmentMajorState {
+  protected:
+    static const uint8_t kNumSegments = 8;
+
+    void clearSegmentPatterns() {
+      memset(mSegmentPatterns, 0, kNumSegments);
+    }
+
+    uint8_t getSegmentPattern(uint8_t segment) const {
+      return mSegmentPatterns[segment];
+    }
+
+    void setSegmentPattern(uint8_t segment, uint8_t pattern) {
+      mSegmentPatterns[segment] = pattern;
+    }
+
+  private:
+    uint8_t mSegmentPatterns[kNumSegments];
+};
+
+/** In the other modes, the segment patterns are not stored. */
+template <>
+class SegmentMajorState<false> {
+  protected:
+    void clearSegmentPatterns() {}
+
+    uint8_t getSegmentPattern(uint8_t /*segment*/) const { return 0; }
+
+    void setSegmentPattern(uint8_t /*segment*/, uint8_t /*pattern*/) {}
+};
+
+/**
+ * The lit digits scanned in the current frame, and the policy for the fields
+ * freed by the blank digits. Used only in kScanSkipBlankDigits mode.
+ */
+template <bool T_SKIP_BLANK, uint8_t T_DIGITS>
+class SkipBlankState {
+  protected:
+    uint8_t getScanDigit(uint8_t i) const { return mScanDigits[i]; }
+
+    void setScanDigit(uint8_t i, uint8_t digit) { mScanDigits[i] = digit; }
+
+    uint8_t getNumScanDigits() const { return mNumScanDigits; }
+
+    void setNumScanDigits(uint8_t n) { mNumScanDigits = n; }
+
+    uint8_t getPolicy() const { return mBlankPolicy; }
+
+    void setPolicy(uint8_t policy) { mBlankPolicy = policy; }
+
+  private:
+    /** Lit digits, in the scan order. */
+    uint8_t mScanDigits[T_DIGITS];
+
+    /** Number of entries of mScanDigits. */
+    uint8_t mNumScanDigits;
+
+    /** One of the kBlankPolicyXxx constants. */
+    uint8_t mBlankPolicy = kBlankPolicyBrighter;
+};
+
+/** In the other modes, all digits are scanned, so nothing is stored. */
+template <uint8_t T_DIGITS>
+class SkipBlankState<false, T_DIGITS> {
+  protected:
+    uint8_t getScanDigit(uint8_t i) const { return i; }
+
+    void setScanDigit(uint8_t /*i*/, uint8_t /*digit*/) {}
+
+    uint8_t getNumScanDigits() const { return T_DIGITS; }
+
+    void setNumScanDigits(uint8_t /*n*/) {}
+
+    uint8_t getPolicy() const { return kBlankPolicyBrighter; }
+
+    void setPolicy(uint8_t /*policy*/) {}
+};
+
+} // internal
+
 /**
  * An implementation of `LedModule` for display modules which do not have
  * hardware controller chips, so they require the microcontroller to perform the
@@ -58,6 +379,35 @@ namespace ace_segment {
  * rendered for T_SUBFIELDS number of times so that the brightness of the digit
  * will be controlled by PWM.
  *
+ * By default, the module scans digit-major, with one field per digit. If
+ * `T_SCAN_MODE` is `kScanSegmentMajor`, the module scans one segment at a time
+ * across all digits, so that a frame always contains 8 fields (times
+ * T_SUBFIELDS), regardless of the number of digits. The segment patterns are
+ * transposed into a digit bit mask per segment at the start of each frame, but
+ * only for the digits which have been marked dirty since the previous frame.
+ * If `T_SCAN_MODE` is `kScanSkipBlankDigits`, the digits whose pattern is 0 are
+ * skipped, and the freed fields are used according to setBlankPolicy().
+ * If `T_SCAN_MODE` is `kScanDualBank`, one digit of each of the 2 banks of
+ * digits is drawn in each field.
+ *
+ * If `T_DITHER_BITS > 0`, each subfield level is divided into
+ * `2^T_DITHER_BITS` finer brightness levels using temporal dithering: a digit
+ * alternates between 2 adjacent subfield levels across successive frames,
+ * selected by an error-diffusion accumulator updated once per frame. This
+ * multiplies the number of brightness levels without increasing the field
+ * rate.
+ *
+ * The `T_SCAN_ORDER` template parameter reorders the fields within a frame, to
+ * reduce the visible flicker at a given frame rate (or to allow a lower frame
+ * rate with the same visible flicker). The orders are precomputed into small
+ * tables at compile-time.
+ *
+ * The ScanningModule normally holds a reference to a LedMatrix instance created
+ * by the caller. If T_LM is `OwnedLedMatrix<LedMatrix>`, the ScanningModule
+ * holds a copy of the LedMatrix passed into the constructor instead, which
+ * avoids the indirection through the reference. The embedded LedMatrix is
+ * accessed through getLedMatrix().
+ *
  * There are 2 ways to get the expected number of frames per second:
  *
  *  1) Call the renderFieldNow() in an ISR, or
@@ -66,39 +416,106 @@ namespace ace_segment {
  *    at the appropriate time.
  *
  * @tparam T_LM the LedMatrixBase class that provides access to LED segments
-      (elements) organized by digit (group)
+      (elements) organized by digit (group), or `OwnedLedMatrix<T_LM>` to
+      embed the LedMatrix
  * @tparam T_DIGITS number of LED digits
  * @tparam T_SUBFIELDS number of subfields for each digit to get brightness
  *    control using PWM. The default is 1, but can be set to greater than 1 to
  *    get brightness control.
  * @tparam T_CI class that provides access to Arduino clock functions (millis()
  *    and micros()). The default is ClockInterface.
+ * @tparam T_SCAN_MODE kScanDigitMajor (default), kScanSegmentMajor,
+ *    kScanSkipBlankDigits, or kScanDualBank
+ * @tparam T_DITHER_BITS number of bits of temporal dithering of the
+ *    brightness (default 0). Used only if T_SUBFIELDS > 1. The maximum
+ *    brightness `T_SUBFIELDS << T_DITHER_BITS` must be at most 255.
+ * @tparam T_SCAN_ORDER kScanOrderSequential (default), or a combination of
+ *    kScanOrderInterleaved and kScanOrderSpreadSubFields
  */
 template <
     typename T_LM,
     uint8_t T_DIGITS,
     uint8_t T_SUBFIELDS = 1,
-    typename T_CI = ClockInterface>
-class ScanningModule : public LedModule {
+    typename T_CI = ClockInterface,
+    uint8_t T_SCAN_MODE = kScanDigitMajor,
+    uint8_t T_DITHER_BITS = 0,
+    uint8_t T_SCAN_ORDER = kScanOrderSequential>
+class ScanningModule :
+    public LedModule,
+    public AutoPowerDown,
+    private internal::SubFieldState<(T_SUBFIELDS > 1)>,
+    private internal::DigitBrightnessState<
+        (T_SUBFIELDS > 1),
+        T_DIGITS,
+        ((T_SUBFIELDS << T_DITHER_BITS) <= 0x0F)>,
+    private internal::FrameBrightnessState<
+        internal::isFrameBrightnessCached(
+            T_SUBFIELDS, T_DITHER_BITS, T_SCAN_MODE),
+        T_DIGITS>,
+    private internal::SegmentMajorState<(T_SCAN_MODE == kScanSegmentMajor)>,
+    private internal::SkipBlankState<
+        (T_SCAN_MODE == kScanSkipBlankDigits), T_DIGITS> {
 
   public:
+    /** The LedMatrix class, unwrapped from OwnedLedMatrix. */
+    using LedMatrix = typename internal::LedMatrixStorage<T_LM>::LedMatrix;
+
+    /** Number of segments of each digit. */
+    static const uint8_t kNumSegments = 8;
+
+    /**
+     * Number of groups scanned in one frame: digits in digit-major mode,
+     * segments in segment-major mode, pairs of digits in dual-bank mode.
+     */
+    static const uint8_t kNumGroups =
+        (T_SCAN_MODE == kScanSegmentMajor) ? kNumSegments
+        : (T_SCAN_MODE == kScanDualBank) ? T_DIGITS / 2
+        : T_DIGITS;
+
+    static_assert(T_SCAN_MODE != kScanDualBank || T_DIGITS % 2 == 0,
+        "kScanDualBank requires an even T_DIGITS");
+
+    /** Brightness which turns on a digit 100% of the time. */
+    static const uint8_t kMaxBrightness = T_SUBFIELDS << T_DITHER_BITS;
+
+    static_assert((uint16_t) T_SUBFIELDS << T_DITHER_BITS <= 255,
+        "T_SUBFIELDS << T_DITHER_BITS must be <= 255");
+
+    /**
+     * Store the brightness of 2 digits in each byte, if all brightness levels
+     * fit in 4 bits.
+     */
+    static const bool kPackBrightnesses = (kMaxBrightness <= 0x0F);
+
+    /**
+     * Cache the subfield brightness of each digit at the start of each frame,
+     * if it is not simply the brightness given to setBrightnessAt(): with
+     * dithering, with a Styler, or with the scaling of
+     * kBlankPolicyConstantBrightness. The fields then read the cached value
+     * instead of recomputing it in every call to renderFieldNow().
+     */
+    static const bool kCacheFrameBrightnesses =
+        internal::isFrameBrightnessCached(
+            T_SUBFIELDS, T_DITHER_BITS, T_SCAN_MODE);
+
     /**
      * Constructor.
      *
-     * @param ledMatrix instance of LedMatrixBase that understanding the wiring
+     * @param ledMatrix instance of LedMatrixBase that understanding the wiring,
+     *    copied into this object if T_LM is OwnedLedMatrix
      * @param framesPerSecond the rate at which all digits of the LED display
-     *    will be refreshed
+     *    will be refreshed, 0 is treated as 1
      * @param numDigits number of digits in the LED display
      * @param patterns array of segment pattern per digit, not nullable
      * @param brightnesses array of brightness for each digit (default: nullptr)
      */
     explicit ScanningModule(
-        const T_LM& ledMatrix,
+        const LedMatrix& ledMatrix,
         uint8_t framesPerSecond
     ):
         LedModule(mPatterns, T_DIGITS),
         mLedMatrix(ledMatrix),
-        mFramesPerSecond(framesPerSecond)
+        mFramesPerSecond(framesPerSecond ? framesPerSecond : 1)
     {}
 
     /**
@@ -109,23 +526,40 @@ class ScanningModule : public LedModule {
      */
     void begin() {
       LedModule::begin();
+      beginPowerDown();
       memset(mPatterns, 0, T_DIGITS);
+      this->clearSegmentPatterns();
+      this->clearFrameStates();
+    #if ACE_SEGMENT_ENABLE_STYLER
+      mStyleOffBits = 0;
+    #endif
+
+      // Scan all digits until the first frame computes the scan set.
+      for (uint8_t i = 0; i < T_DIGITS; i++) {
+        this->setScanDigit(i, i);
+      }
+      this->setNumScanDigits(T_DIGITS);
 
       // Set up durations for the renderFieldWhenReady() polling function.
-      mMicrosPerField = (uint32_t) 1000000UL / getFieldsPerSecond();
+      updateMicrosPerField();
       mLastRenderFieldMicros = T_CI::micros();
 
       // Initialize variables needed for multiplexing.
-      mCurrentDigit = 0;
-      mPrevDigit = T_DIGITS - 1;
-      mCurrentSubField = 0;
-      mPattern = 0;
+      mCurrentGroup = 0;
+      mPrevGroup = kNumGroups - 1;
+      this->setCurrentSubField(0);
+      this->setDrawnPattern(0);
 
-      // Set initial patterns and global brightness.
-      mIsDigitBrightnessDirty = false;
+      // Set initial patterns and global brightness. With subfields, the
+      // global brightness is in units of subfields, and the hardware
+      // brightness of the LedMatrix (if any) stays at its full duty cycle.
+      // Otherwise, the global brightness is the 0-255 hardware brightness.
       mLedMatrix.clear();
       if (T_SUBFIELDS > 1) {
-        setBrightness(T_SUBFIELDS / 2); // half brightness
+        setBrightness(kMaxBrightness / 2); // half brightness
+        mLedMatrix.setBrightness(255);
+      } else {
+        setBrightness(255);
       }
     }
 
@@ -135,6 +569,9 @@ class ScanningModule : public LedModule {
       LedModule::end();
     }
 
+    /** Return the LedMatrix, which may be embedded in this object. */
+    const LedMatrix& getLedMatrix() const { return mLedMatrix; }
+
     //-----------------------------------------------------------------------
     // Additional brightness control. ScanningModule allows brightness to be
     // defined on a per-digit basis.
@@ -151,6 +588,10 @@ class ScanningModule : public LedModule {
      * 16 which turns ON the digit 100% of the time. The relative brightness of
      * each brightness level is in units of 1/T_SUBFIELDS.
      *
+     * If T_DITHER_BITS > 0, the maximum brightness is kMaxBrightness, i.e.
+     * `T_SUBFIELDS << T_DITHER_BITS`, and each brightness level is in units of
+     * 1/kMaxBrightness, averaged over `2^T_DITHER_BITS` frames.
+     *
      * The brightness scale is *not* normalized to [0,255]. A previous version
      * of this class tried to do that, but I found that this introduced
      * discretization errors which made it difficult to control the brightness
@@ -162,12 +603,15 @@ class ScanningModule : public LedModule {
      * brightness values in these raw units. The side benefit of using raw
      * brightness values is that it makes displayCurrentFieldModulated() easier
      * to implement.
+     *
+     * If T_SUBFIELDS <= 1, the per-digit brightness is not stored, and this
+     * method does nothing.
      */
     void setBrightnessAt(uint8_t pos, uint8_t brightness) {
+      if (T_SUBFIELDS <= 1) return;
       if (pos >= T_DIGITS) return;
-      mBrightnesses[pos] = (brightness >= T_SUBFIELDS)
-          ? T_SUBFIELDS : brightness;
-      mIsDigitBrightnessDirty = true;
+      if (brightness > kMaxBrightness) brightness = kMaxBrightness;
+      this->setDigitBrightness(pos, brightness);
     }
 
     //-----------------------------------------------------------------------
@@ -177,13 +621,49 @@ class ScanningModule : public LedModule {
     /** Return the requested frames per second. */
     uint16_t getFramesPerSecond() const { return mFramesPerSecond; }
 
+    /**
+     * Change the frames per second after begin(). This recomputes
+     * getMicrosPerField(). If renderFieldNow() is called from a timer
+     * interrupt, the timer must be reprogrammed, which ScanningTimer does
+     * automatically. A framesPerSecond of 0 is treated as 1.
+     */
+    void setFramesPerSecond(uint8_t framesPerSecond) {
+      mFramesPerSecond = framesPerSecond ? framesPerSecond : 1;
+      updateMicrosPerField();
+    }
+
+    /**
+     * Select how the fields freed by the blank digits are used in the
+     * kScanSkipBlankDigits mode: kBlankPolicyBrighter (default),
+     * kBlankPolicyLowerRate, or kBlankPolicyConstantBrightness. Ignored in the
+     * other modes.
+     */
+    void setBlankPolicy(uint8_t policy) {
+      this->setPolicy(policy);
+      updateMicrosPerField();
+    }
+
+    /** Return the blank policy. */
+    uint8_t getBlankPolicy() const { return this->getPolicy(); }
+
+    /**
+     * Return the number of digits (or segments) scanned in the current frame.
+     * Smaller than kNumGroups in kScanSkipBlankDigits mode if some digits are
+     * blank.
+     */
+    uint8_t getNumScanGroups() const {
+      return (T_SCAN_MODE == kScanSkipBlankDigits)
+          ? this->getNumScanDigits()
+          : kNumGroups;
+    }
+
     /** Return the fields per second. */
     uint16_t getFieldsPerSecond() const {
       return mFramesPerSecond * getFieldsPerFrame();
     }
 
-    /** Total fields per frame across all digits. */
-    uint16_t getFieldsPerFrame() const { return T_DIGITS * T_SUBFIELDS; }
+    /** Total fields per frame across all digits (or segments). */
+    uint16_t getFieldsPerFrame() const { return kNumGroups * T_SUBFIELDS; }
 
     /**
      * Return micros per field. This is how often renderFieldNow() must be
@@ -191,6 +671,25 @@ class ScanningModule : public LedModule {
      */
     uint16_t getMicrosPerField() const { return mMicrosPerField; }
 
+    /**
+     * Return the number of micros until renderFieldWhenReady() will render the
+     * next field, or 0 if the field is already due. A low-power loop() can
+     * sleep for this duration instead of polling renderFieldWhenReady()
+     * continuously.
+     */
+    uint32_t getMicrosUntilNextField() const {
+      // A powered down display has nothing to render until a digit becomes
+      // lit, unless a Styler changes the digits over time.
+      if (isPoweredDown() && getStyler() == nullptr && isDark()) {
+        return kMicrosNoDeadline;
+      }
+
+      uint16_t elapsedMicros = T_CI::micros() - mLastRenderFieldMicros;
+      return (elapsedMicros >= mMicrosPerField)
+          ? 0
+          : mMicrosPerField - elapsedMicros;
+    }
+
     /**
      * Display one field of a frame when the time is right. This is a polling
      * method, so call this slightly more frequently than getFieldsPerSecond()
@@ -213,42 +712,224 @@ class ScanningModule : public LedModule {
 
     /**
      * Render the current field immediately. If modulation is off (i.e.
-     * T_SUBFIELDS == 1), then the field corresponds to the single digit. If
-     * modulation is enabled (T_SUBFIELDS > 1), then each digit is PWM modulated
-     * over T_SUBFIELDS number of renderings.
+     * T_SUBFIELDS == 1), then the field corresponds to the single digit (or
+     * segment). If modulation is enabled (T_SUBFIELDS > 1), then each digit
+     * is PWM modulated over T_SUBFIELDS number of renderings.
      *
      * This method is intended to be called directly from a timer interrupt
      * handler.
+     *
+     * If setAutoPowerDown() is enabled, a dark display is cleared once at the
+     * start of a frame, then each call returns without drawing anything until
+     * a digit becomes lit. Each call still checks whether the digits are
+     * dark, so a timer interrupt which calls this keeps firing, at a lower cost
+     * per call.
      */
     void renderFieldNow() {
       updateBrightness();
-      if (T_SUBFIELDS > 1) {
-        displayCurrentFieldModulated();
-      } else {
-        displayCurrentFieldPlain();
+      if (mCurrentGroup == 0 && this->getCurrentSubField() == 0) {
+        // Start of a new frame.
+        if (getStyler()) updateStyler(T_CI::millis());
+        updateStyleOffBits();
+        if (updatePowerDown(isAutoPowerDown() && isDark())
+            && isPoweredDown()) {
+          mLedMatrix.clear();
+        }
+        if (isPoweredDown()) return;
+        if (T_SCAN_MODE == kScanSegmentMajor) {
+          updateSegmentPatterns();
+        } else if (T_SCAN_MODE == kScanSkipBlankDigits) {
+          updateScanDigits();
+        }
+        if (kCacheFrameBrightnesses) {
+          updateFrameBrightnesses();
+        }
       }
+      displayCurrentField(ScanModeTag<T_SCAN_MODE == kScanDualBank>());
+    }
+
+    //-----------------------------------------------------------------------
+    // Methods related to a key matrix which shares the group pins.
+    //-----------------------------------------------------------------------
+
+    /**
+     * Return the keys sampled by the LedMatrix while each group was enabled
+     * by renderFieldNow(), one bit per group, 1 meaning pressed. Requires an
+     * LedMatrix with a key matrix, e.g. LedMatrixDirect or
+     * LedMatrixSingleHc595 with T_KEYS set to true. Each bit is refreshed once
+     * per frame. Safe to call while an ISR calls renderFieldNow().
+     *
+     * In kScanSkipBlankDigits mode, the blank digits are not enabled, so their
+     * keys cannot be sampled. They are reported as released, instead of the
+     * state they had before the digit became blank.
+     */
+    uint32_t readButtonBits() const {
+      uint16_t keyBits = mLedMatrix.getKeyBits();
+      if (T_SCAN_MODE == kScanSkipBlankDigits) {
+        uint16_t scanBits = 0;
+        for (uint8_t i = 0; i < this->getNumScanDigits(); i++) {
+          scanBits |= (uint16_t) 0x1 << this->getScanDigit(i);
+        }
+        keyBits &= scanBits;
+      }
+      return keyBits;
     }
 
   private:
     friend class ::ScanningModuleTest_isAnyDigitDirty;
     friend class ::ScanningModuleTest_isBrightnessDirty;
+    friend class ::ScanningModuleTest_segmentMajor;
+    friend class ::ScanningModuleTest_dithering;
+
+    /** Order of the groups within a frame, if kScanOrderInterleaved. */
+    using GroupOrder = internal::ScanOrderTable<kNumGroups, false>;
+
+    /** Order of the subfields within a frame, if kScanOrderSpreadSubFields. */
+    using SubFieldOrder = internal::ScanOrderTable<T_SUBFIELDS, true>;
 
     // disable copy-constructor and assignment operator
     ScanningModule(const ScanningModule&) = delete;
     ScanningModule& operator=(const ScanningModule&) = delete;
 
+    /**
+     * Recompute mMicrosPerField from the frames per second, and from the
+     * number of scanned digits for kBlankPolicyLowerRate. A period longer than
+     * 65535 micros (e.g. a single field per frame below 16 frames per second)
+     * is clamped to UINT16_MAX, which raises the frame rate to about 15.3.
+     */
+    void updateMicrosPerField() {
+      uint16_t fieldsPerSecond = getFieldsPerSecond();
+      if (T_SCAN_MODE == kScanSkipBlankDigits
+          && this->getPolicy() == kBlankPolicyLowerRate) {
+        fieldsPerSecond =
+            mFramesPerSecond * this->getNumScanDigits() * T_SUBFIELDS;
+      }
+      uint32_t microsPerField = (uint32_t) 1000000UL / fieldsPerSecond;
+      mMicrosPerField = (microsPerField > UINT16_MAX)
+          ? UINT16_MAX
+          : microsPerField;
+    }
+
+    /**
+     * Return the digit (or segment) at the given position of the scan order.
+     * In kScanSkipBlankDigits mode, the scan set is built in the scan order.
+     */
+    static uint8_t getGroupInScanOrder(uint8_t pos) {
+      return internal::ScanOrder<
+          (T_SCAN_ORDER & kScanOrderInterleaved) != 0, GroupOrder>::at(pos);
+    }
+
+    /**
+     * Return the digit (or segment) drawn by the current field. In
+     * kScanSkipBlankDigits mode, mCurrentGroup is the index into the scan set.
+     */
+    uint8_t getCurrentDigit() const {
+      return (T_SCAN_MODE == kScanSkipBlankDigits)
+          ? this->getScanDigit(mCurrentGroup)
+          : getGroupInScanOrder(mCurrentGroup);
+    }
+
+    /**
+     * Return the rank of the current subfield, which is compared against the
+     * brightness to decide if the digit is on.
+     */
+    uint8_t getCurrentSubFieldRank() const {
+      return internal::ScanOrder<
+          (T_SCAN_ORDER & kScanOrderSpreadSubFields) != 0, SubFieldOrder>::at(
+              this->getCurrentSubField());
+    }
+
+    /**
+     * Tag type which selects the overload of displayCurrentField() at
+     * compile-time, so that LedMatrix::drawBanks() is required only in the
+     * kScanDualBank mode.
+     */
+    template <bool T_DUAL_BANK>
+    struct ScanModeTag {};
+
+    /** Display the current field with a single digit (or segment). */
+    void displayCurrentField(ScanModeTag<false>) {
+      if (T_SUBFIELDS > 1) {
+        displayCurrentFieldModulated();
+      } else {
+        displayCurrentFieldPlain();
+      }
+    }
+
+    /**
+     * Display the current field with one digit from each bank, with or without
+     * subfield modulation.
+     */
+    void displayCurrentField(ScanModeTag<true>) {
+      const uint8_t group = getCurrentDigit();
+      const uint8_t digitB = group + kNumGroups;
+      const uint8_t patternA = (T_SUBFIELDS > 1)
+          ? getModulatedDigitPattern(group)
+          : getFramePatternAt(group);
+      const uint8_t patternB = (T_SUBFIELDS > 1)
+          ? getModulatedDigitPattern(digitB)
+          : getFramePatternAt(digitB);
+      mLedMatrix.drawBanks(group, patternA, patternB);
+      mPrevGroup = group;
+      advanceField();
+    }
+
     /** Display field normally without modulation. */
     void displayCurrentFieldPlain() {
-      const uint8_t pattern = mPatterns[mCurrentDigit];
-      mLedMatrix.draw(mCurrentDigit, pattern);
-      mPrevDigit = mCurrentDigit;
-      ace_common::incrementMod(mCurrentDigit, T_DIGITS);
+      const uint8_t digit = getCurrentDigit();
+      const uint8_t pattern = (T_SCAN_MODE == kScanSegmentMajor)
+          ? this->getSegmentPattern(digit)
+          : getFramePatternAt(digit);
+      mLedMatrix.draw(digit, pattern);
+      mPrevGroup = digit;
+      advanceField();
     }
 
     /** Display field using subfield modulation. */
     void displayCurrentFieldModulated() {
+      const uint8_t digit = getCurrentDigit();
+      const uint8_t pattern = (T_SCAN_MODE == kScanSegmentMajor)
+          ? getModulatedSegmentPattern(digit)
+          : getModulatedDigitPattern(digit);
+
+      if (pattern != this->getDrawnPattern() || digit != mPrevGroup) {
+        mLedMatrix.draw(digit, pattern);
+        this->setDrawnPattern(pattern);
+      }
+
+      mPrevGroup = digit;
+      advanceField();
+    }
+
+    /**
+     * Advance to the next field: the next subfield of the current digit, or
+     * the next digit (or segment), in the order selected by T_SCAN_ORDER.
+     */
+    void advanceField() {
+      if (T_SUBFIELDS <= 1) {
+        ace_common::incrementMod(mCurrentGroup, getNumScanGroups());
+      } else if (T_SCAN_ORDER & kScanOrderSpreadSubFields) {
+        // Scan every digit in this subfield before the next subfield.
+        ace_common::incrementMod(mCurrentGroup, getNumScanGroups());
+        if (mCurrentGroup == 0) {
+          uint8_t subField = this->getCurrentSubField();
+          ace_common::incrementMod(subField, T_SUBFIELDS);
+          this->setCurrentSubField(subField);
+        }
+      } else {
+        uint8_t subField = this->getCurrentSubField() + 1;
+        if (subField >= T_SUBFIELDS) {
+          ace_common::incrementMod(mCurrentGroup, getNumScanGroups());
+          subField = 0;
+        }
+        this->setCurrentSubField(subField);
+      }
+    }
+
+    /** Return the pattern of the given digit in the current subfield. */
+    uint8_t getModulatedDigitPattern(uint8_t digit) const {
       // Calculate the maximum subfield duration for current digit.
-      const uint8_t brightness = mBrightnesses[mCurrentDigit];
+      const uint8_t brightness = getFrameBrightnessAt(digit);
 
       // Implement pulse width modulation PWM, using the following boundaries:
       //
@@ -259,32 +940,202 @@ class ScanningModule : public LedModule {
       // be in the range of [0, T_SUBFIELDS-1]. The brightness will always be <=
       // T_SUBFIELDS, with the value of T_SUBFIELDS being 100% bright. So if we
       // turn on the LED when (mCurrentSubField < brightness), we get the
-      // desired outcome.
-      const uint8_t pattern = (mCurrentSubField < brightness)
-          ? mPatterns[mCurrentDigit]
+      // desired outcome. The subfield rank is a permutation of
+      // mCurrentSubField, so the same is true for kScanOrderSpreadSubFields.
+      return (getCurrentSubFieldRank() < brightness)
+          ? getFramePatternAt(digit)
           : 0;
+    }
+
+    /**
+     * Return the digit bit mask of the current segment in the current
+     * subfield. Same PWM logic as getModulatedDigitPattern(), applied to each
+     * digit in parallel.
+     */
+    uint8_t getModulatedSegmentPattern(uint8_t segment) const {
+      const uint8_t rank = getCurrentSubFieldRank();
+      uint8_t onDigits = 0;
+      for (uint8_t digit = 0; digit < T_DIGITS; digit++) {
+        if (rank < getFrameBrightnessAt(digit)) {
+          onDigits |= (0x1 << digit);
+        }
+      }
+      return this->getSegmentPattern(segment) & onDigits;
+    }
+
+    /**
+     * Transpose the patterns of the dirty digits into the segment patterns, then
+     * clear the dirty bits. In segment-major mode, a dirty digit means that its
+     * pattern has not yet been transposed.
+     */
+    void updateSegmentPatterns() {
+      const uint8_t dirtyBits = getDigitDirtyBits();
+      if (dirtyBits == 0) return;
+
+      for (uint8_t digit = 0; digit < T_DIGITS; digit++) {
+        const uint8_t digitBit = (0x1 << digit);
+        if (! (dirtyBits & digitBit)) continue;
+
+        uint8_t pattern = getFramePatternAt(digit);
+        for (uint8_t segment = 0; segment < kNumSegments; segment++) {
+          uint8_t segmentPattern = this->getSegmentPattern(segment);
+          if (pattern & 0x1) {
+            segmentPattern |= digitBit;
+          } else {
+            segmentPattern &= ~digitBit;
+          }
+          this->setSegmentPattern(segment, segmentPattern);
+          pattern >>= 1;
+        }
+      }
+      clearDigitsDirty();
+    }
+
+    /**
+     * Record the digits blanked by their style in the current frame, so that
+     * the fields read the styled patterns without calling the Styler.
+     */
+    void updateStyleOffBits() {
+    #if ACE_SEGMENT_ENABLE_STYLER
+      uint8_t offBits = 0;
+      const Styler* styler = getStyler();
+      if (styler) {
+        for (uint8_t digit = 0; digit < T_DIGITS; digit++) {
+          if (styler->applyPattern(digit, 0xFF) == 0) {
+            offBits |= (0x1 << digit);
+          }
+        }
+      }
+      mStyleOffBits = offBits;
+    #endif
+    }
+
+    /** Return the pattern of the digit in the current frame. */
+    uint8_t getFramePatternAt(uint8_t digit) const {
+    #if ACE_SEGMENT_ENABLE_STYLER
+      if (mStyleOffBits & (0x1 << digit)) return 0;
+    #endif
+      return mPatterns[digit];
+    }
+
+    /**
+     * Return the brightness of the digit in subfields for the current frame,
+     * after applying its style, the scaling of kBlankPolicyConstantBrightness,
+     * and its dithering if T_DITHER_BITS > 0.
+     */
+    uint8_t getFrameBrightnessAt(uint8_t digit) const {
+      return kCacheFrameBrightnesses
+          ? (this->getFrameState(digit) >> T_DITHER_BITS)
+          : getStoredBrightnessAt(digit);
+    }
+
+    /** Return the brightness given to setBrightnessAt(). */
+    uint8_t getStoredBrightnessAt(uint8_t digit) const {
+      if (T_SUBFIELDS <= 1) return kMaxBrightness;
+      return this->getDigitBrightness(digit);
+    }
+
+    /**
+     * Compute the subfield brightness of each digit for the next frame. In
+     * kBlankPolicyConstantBrightness, the digit is scanned T_DIGITS/N times as
+     * often, so its on-time is scaled down to keep the same average
+     * brightness. With dithering, the fractional part of the brightness is
+     * added to an accumulator, and the digit is rendered one subfield brighter
+     * in the frames where the accumulator overflows, so the average over
+     * `2^T_DITHER_BITS` frames is the requested brightness.
+     */
+    void updateFrameBrightnesses() {
+      const uint8_t fractionMask = (1 << T_DITHER_BITS) - 1;
+      const Styler* styler = getStyler();
+      for (uint8_t digit = 0; digit < T_DIGITS; digit++) {
+        uint8_t brightness = getStoredBrightnessAt(digit);
+        if (styler) {
+          brightness = styler->applyBrightness(digit, brightness);
+        }
+        if (T_SCAN_MODE == kScanSkipBlankDigits
+            && this->getPolicy() == kBlankPolicyConstantBrightness) {
+          brightness =
+              ((uint16_t) brightness * this->getNumScanDigits() + T_DIGITS / 2)
+              / T_DIGITS;
+        }
+
+        uint8_t level = brightness >> T_DITHER_BITS;
+        uint8_t error = (this->getFrameState(digit) & fractionMask)
+            + (brightness & fractionMask);
+        if (error > fractionMask) {
+          error -= (fractionMask + 1);
+          level++;
+        }
+
+        // The level is at most kMaxBrightness >> T_DITHER_BITS, so both
+        // values fit in a byte.
+        this->setFrameState(digit, (level << T_DITHER_BITS) | error);
+      }
+    }
+
+    /**
+     * Return true if no digit is lit: all styled patterns are 0, or with
+     * T_SUBFIELDS > 1, the styled brightness of each non-blank digit is 0, or
+     * with T_SUBFIELDS == 1, the hardware brightness of the LedMatrix is 0.
+     */
+    bool isDark() const {
+      if (T_SUBFIELDS <= 1
+          && LedMatrix::kHasBrightness
+          && getBrightness() == 0) {
+        return true;
+      }
+
+      for (uint8_t digit = 0; digit < T_DIGITS; digit++) {
+        if (getFramePatternAt(digit) != 0
+            && (T_SUBFIELDS <= 1
+                || getStyledBrightnessAt(digit, getStoredBrightnessAt(digit))
+                    != 0)) {
+          return false;
+        }
+      }
+      return true;
+    }
 
-      if (pattern != mPattern || mCurrentDigit != mPrevDigit) {
-        mLedMatrix.draw(mCurrentDigit, pattern);
-        mPattern = pattern;
+    /**
+     * Recompute the scan set from the lit digits, if any digit is dirty, then
+     * clear the dirty bits. If all digits are blank, digit 0 is scanned so
+     * that the blank pattern is still drawn.
+     */
+    void updateScanDigits() {
+      if (getDigitDirtyBits() == 0) return;
+
+      uint8_t numScanDigits = 0;
+      for (uint8_t pos = 0; pos < T_DIGITS; pos++) {
+        const uint8_t digit = getGroupInScanOrder(pos);
+        if (getFramePatternAt(digit) != 0) {
+          this->setScanDigit(numScanDigits++, digit);
+        }
       }
+      if (numScanDigits == 0) {
+        this->setScanDigit(0, 0);
+        numScanDigits = 1;
+      }
+      clearDigitsDirty();
 
-      mCurrentSubField++;
-      mPrevDigit = mCurrentDigit;
-      if (mCurrentSubField >= T_SUBFIELDS) {
-        ace_common::incrementMod(mCurrentDigit, T_DIGITS);
-        mCurrentSubField = 0;
+      if (numScanDigits != this->getNumScanDigits()) {
+        this->setNumScanDigits(numScanDigits);
+        updateMicrosPerField();
       }
     }
 
     /**
-     * Transfer the global brightness to the per-digit brightness and update the
-     * appropriate flags.
+     * Transfer the global brightness to the per-digit brightness if
+     * T_SUBFIELDS > 1, otherwise to the LED matrix (which may support hardware
+     * brightness in the range 0-255), then update the appropriate flags.
      */
     void updateBrightness() {
       if (isBrightnessDirty()) {
-        for (uint8_t i = 0; i < T_DIGITS; i++) {
-          setBrightnessAt(i, getBrightness());
+        if (T_SUBFIELDS > 1) {
+          for (uint8_t i = 0; i < T_DIGITS; i++) {
+            setBrightnessAt(i, getBrightness());
+          }
+        } else {
+          mLedMatrix.setBrightness(getBrightness());
         }
 
         // Clear the global brightness dirty flag.
@@ -296,14 +1147,15 @@ class ScanningModule : public LedModule {
     // The ordering of the fields below partially motivated to save memory on
     // 32-bit processors.
 
-    /** LedMatrixBase instance that knows how to set and unset LED segments. */
-    const T_LM& mLedMatrix;
+    /**
+     * LedMatrixBase instance that knows how to set and unset LED segments.
+     * Either a reference, or an embedded instance if T_LM is OwnedLedMatrix.
+     */
+    typename internal::LedMatrixStorage<T_LM>::Type mLedMatrix;
 
     /** Pattern for each digit. */
     uint8_t mPatterns[T_DIGITS];
 
-    /** Brightness for each digit. Unused if T_SUBFIELDS <= 1. */
-    uint8_t mBrightnesses[T_DIGITS];
 
     //-----------------------------------------------------------------------
     // Variables needed by renderFieldWhenReady() to render frames and fields at
@@ -317,44 +1169,34 @@ class ScanningModule : public LedModule {
     uint16_t mLastRenderFieldMicros;
 
     /** Number of full frames (all digits) rendered per second. */
-    uint8_t const mFramesPerSecond;
+    uint8_t mFramesPerSecond;
 
     //-----------------------------------------------------------------------
     // Variables needed to keep track of the multiplexing of the digits,
     // and PWM of a single digit.
     //-----------------------------------------------------------------------
 
-    /** Dirty flag for any of the digit-specific brightness. */
-    bool mIsDigitBrightnessDirty;
+  #if ACE_SEGMENT_ENABLE_STYLER
+    /** Digits blanked by their style in the current frame. */
+    uint8_t mStyleOffBits;
+  #endif
 
     /**
-     * Within the renderFieldNow() method, mCurrentDigit is the current
-     * digit that is being drawn. It is incremented to the next digit just
-     * before returning from that method.
+     * Within the renderFieldNow() method, mCurrentGroup is the position in the
+     * scan order of the current digit (or segment in segment-major mode) that
+     * is being drawn. It is incremented to the next position just before
+     * returning from that method.
      */
-    uint8_t mCurrentDigit;
+    uint8_t mCurrentGroup;
 
     /**
-     * Within the renderFieldNow() method, the mPrevDigit is the digit
+     * Within the renderFieldNow() method, the mPrevGroup is the group
      * that was displayed on the previous call to renderFieldNow(). It is
-     * set to the digit that was just displayed before returning. It will be
-     * equal to mCurrentDigit when multiple fields are drawn for the same
-     * digit.
+     * set to the group that was just displayed before returning. It will be
+     * equal to mCurrentGroup when multiple fields are drawn for the same
+     * group.
      */
-    uint8_t mPrevDigit;
-
-    /**
-     * Used by displayCurrentFieldModulated() and subclasses generated by
-     * fast_driver.py.
-     */
-    uint8_t mCurrentSubField;
-
-    /**
-     * The segment pattern that is currently displaying on the LED. Used to
-     * optimize the displayCurrentFieldModulated() method if the current
-     * pattern is the same as the previous pattern.
-     */
-    uint8_t mPattern;
+    uint8_t mPrevGroup;
 };
 
 }
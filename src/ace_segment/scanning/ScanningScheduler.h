@@ -0,0 +1,372 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_SCANNING_SCHEDULER_H
+#define ACE_SEGMENT_SCANNING_SCHEDULER_H
+
+#include <stdint.h>
+#include <Arduino.h> // noInterrupts(), interrupts()
+#include "../hw/ClockInterface.h" // ClockInterface
+#include "../hw/TimerInterface.h" // TimerInterface, TimerIsr
+
+namespace ace_segment {
+
+/**
+ * Drive the renderFieldNow() method of several ScanningModules from a single
+ * timer interrupt, for microcontrollers with few hardware timers.
+ *
+ * The timer ticks at the greatest common divisor of the getMicrosPerField() of
+ * the modules (i.e. the least common multiple of their field rates), but not
+ * faster than `minMicrosPerTick`. Each module renders one field every
+ * `divider` ticks, where `divider` is its field period in ticks, rounded to the
+ * nearest integer. The rounding changes the frame rate of a module when its
+ * field period is not a multiple of the tick.
+ *
+ * The modules are staggered by giving each one a phase offset in
+ * `[0, divider)`, chosen by begin() to collide with the fewest modules already
+ * scheduled. For example, two modules with a divider of 2 are rendered on
+ * alternate ticks, so the amount of work performed by the interrupt stays
+ * roughly constant.
+ *
+ * The interval between 2 successive fields of each module is measured using
+ * `T_CI::micros()`, so that the jitter introduced by the shared interrupt can
+ * be monitored on the real hardware. These measurements are 16-bit values
+ * written by the interrupt, so their accessors disable interrupts.
+ *
+ * The schedule is computed by begin() and is not updated automatically when
+ * the field period of a module changes, because recomputing it in the
+ * interrupt would be too slow. Call sync() from the main code after changing
+ * the frame rate of a module. A module using kBlankPolicyLowerRate changes its
+ * own field period from the interrupt, which is picked up only by the next
+ * sync(); until then, the module keeps its previous divider.
+ *
+ * The interrupt service routine must be a plain function, so only one
+ * ScanningScheduler can be active for a given combination of template
+ * parameters.
+ *
+ * @tparam T_TI class that implements the TimerInterface static methods
+ * @tparam T_MAX_MODULES maximum number of modules
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()). The default is ClockInterface.
+ */
+template <
+    typename T_TI,
+    uint8_t T_MAX_MODULES,
+    typename T_CI = ClockInterface>
+class ScanningScheduler {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param minMicrosPerTick the shortest timer period allowed, which limits
+     *    the overhead of the interrupt when the field periods of the modules
+     *    have a small common divisor
+     */
+    explicit ScanningScheduler(uint16_t minMicrosPerTick) :
+        mMinMicrosPerTick(minMicrosPerTick)
+    {}
+
+    /**
+     * Add a module (e.g. a ScanningModule or Hc595Module). Must be called
+     * before begin(). Return false if there is no room.
+     */
+    template <typename T_MODULE>
+    bool addModule(T_MODULE& module) {
+      if (mNumModules >= T_MAX_MODULES) return false;
+
+      Task& task = mTasks[mNumModules];
+      task.render = renderModule<T_MODULE>;
+      task.microsPerField = microsPerFieldOfModule<T_MODULE>;
+      task.module = &module;
+      mNumModules++;
+      return true;
+    }
+
+    /**
+     * Compute the schedule from the current getMicrosPerField() of the modules,
+     * and start the timer. The begin() method of each module must be called
+     * before this.
+     */
+    void begin() {
+      updateSchedule();
+      updatePhases();
+      resetJitter();
+
+      sScheduler = this;
+      T_TI::begin(mMicrosPerTick, isr);
+    }
+
+    /**
+     * Recompute the schedule from the current getMicrosPerField() of the
+     * modules, and reprogram the timer if the tick changed. Return true if the
+     * tick or any divider changed, in which case the phases are reassigned and
+     * the jitter measurements are restarted. Must be called from the main code
+     * (not from an interrupt), because the interrupts are disabled while the
+     * schedule is updated.
+     */
+    bool sync() {
+      noInterrupts();
+      uint16_t prevMicrosPerTick = mMicrosPerTick;
+      bool changed = updateSchedule();
+      if (changed) {
+        updatePhases();
+        resetJitterUnguarded();
+        if (mMicrosPerTick != prevMicrosPerTick) {
+          T_TI::setPeriod(mMicrosPerTick);
+        }
+      }
+      interrupts();
+      return changed;
+    }
+
+    /** Stop the timer. */
+    void end() {
+      T_TI::end();
+      sScheduler = nullptr;
+    }
+
+    /** Return the number of modules. */
+    uint8_t getNumModules() const { return mNumModules; }
+
+    /** Return the period of the timer. Valid after begin(). */
+    uint16_t getMicrosPerTick() const { return mMicrosPerTick; }
+
+    /** Return the number of ticks between fields of module i. */
+    uint8_t getDividerAt(uint8_t i) const { return mTasks[i].divider; }
+
+    /** Return the tick (modulo the divider) of the fields of module i. */
+    uint8_t getPhaseAt(uint8_t i) const { return mTasks[i].phase; }
+
+    /** Return the shortest measured interval between fields of module i. */
+    uint16_t getMinFieldMicrosAt(uint8_t i) const {
+      noInterrupts();
+      uint16_t micros = mTasks[i].minFieldMicros;
+      interrupts();
+      return micros;
+    }
+
+    /** Return the longest measured interval between fields of module i. */
+    uint16_t getMaxFieldMicrosAt(uint8_t i) const {
+      noInterrupts();
+      uint16_t micros = mTasks[i].maxFieldMicros;
+      interrupts();
+      return micros;
+    }
+
+    /**
+     * Return the field jitter of module i, the difference between the longest
+     * and shortest measured interval between fields. Returns 0 until 2
+     * intervals have been measured.
+     */
+    uint16_t getFieldJitterMicrosAt(uint8_t i) const {
+      noInterrupts();
+      uint16_t minMicros = mTasks[i].minFieldMicros;
+      uint16_t maxMicros = mTasks[i].maxFieldMicros;
+      interrupts();
+      return (maxMicros < minMicros) ? 0 : maxMicros - minMicros;
+    }
+
+    /** Restart the measurement of the field intervals. */
+    void resetJitter() {
+      noInterrupts();
+      resetJitterUnguarded();
+      interrupts();
+    }
+
+  private:
+    /** A module with its scheduling and jitter state. */
+    struct Task {
+      /** Calls T_MODULE::renderFieldNow() on module. */
+      void (*render)(void* module);
+
+      /** Calls T_MODULE::getMicrosPerField() on module. */
+      uint16_t (*microsPerField)(void* module);
+
+      void* module;
+
+      /** Timestamp of the last field. */
+      uint16_t lastMicros;
+      uint16_t minFieldMicros;
+      uint16_t maxFieldMicros;
+
+      uint8_t divider;
+      uint8_t phase;
+
+      /** Number of ticks until the next field. */
+      uint8_t counter;
+
+      bool hasLastMicros;
+    };
+
+    template <typename T_MODULE>
+    static void renderModule(void* module) {
+      static_cast<T_MODULE*>(module)->renderFieldNow();
+    }
+
+    template <typename T_MODULE>
+    static uint16_t microsPerFieldOfModule(void* module) {
+      return static_cast<T_MODULE*>(module)->getMicrosPerField();
+    }
+
+    /** The interrupt service routine. */
+    static void isr() {
+      if (sScheduler) sScheduler->tick();
+    }
+
+    static uint16_t gcd(uint16_t a, uint16_t b) {
+      while (b != 0) {
+        uint16_t t = a % b;
+        a = b;
+        b = t;
+      }
+      return a;
+    }
+
+    /**
+     * Recompute mMicrosPerTick and the divider of each module. Return true if
+     * any of them changed.
+     */
+    bool updateSchedule() {
+      uint16_t prevMicrosPerTick = mMicrosPerTick;
+      updateMicrosPerTick();
+      bool changed = (mMicrosPerTick != prevMicrosPerTick);
+      for (uint8_t i = 0; i < mNumModules; i++) {
+        Task& task = mTasks[i];
+        uint32_t divider =
+            ((uint32_t) task.microsPerField(task.module) + mMicrosPerTick / 2)
+            / mMicrosPerTick;
+        if (divider == 0) divider = 1;
+        if (divider != task.divider) changed = true;
+        task.divider = divider;
+      }
+      return changed;
+    }
+
+    /** Assign the phase of each module, and restart its tick counter. */
+    void updatePhases() {
+      for (uint8_t i = 0; i < mNumModules; i++) {
+        Task& task = mTasks[i];
+        task.phase = findPhase(i);
+        task.counter = task.phase;
+      }
+    }
+
+    /** Restart the jitter measurement, with the interrupts already blocked. */
+    void resetJitterUnguarded() {
+      for (uint8_t i = 0; i < mNumModules; i++) {
+        Task& task = mTasks[i];
+        task.hasLastMicros = false;
+        task.minFieldMicros = UINT16_MAX;
+        task.maxFieldMicros = 0;
+      }
+    }
+
+    /**
+     * Set mMicrosPerTick to the GCD of the field periods, limited to
+     * mMinMicrosPerTick, and large enough that every divider fits in 8 bits.
+     */
+    void updateMicrosPerTick() {
+      uint16_t micros = 0;
+      uint16_t maxMicros = 0;
+      for (uint8_t i = 0; i < mNumModules; i++) {
+        const Task& task = mTasks[i];
+        uint16_t fieldMicros = task.microsPerField(task.module);
+        micros = gcd(micros, fieldMicros);
+        if (fieldMicros > maxMicros) maxMicros = fieldMicros;
+      }
+      if (micros < mMinMicrosPerTick) micros = mMinMicrosPerTick;
+      uint16_t minMicros = (maxMicros + 254) / 255;
+      if (micros < minMicros) micros = minMicros;
+      mMicrosPerTick = (micros == 0) ? 1 : micros;
+    }
+
+    /**
+     * Return the phase of module i which coincides with the fewest of the
+     * modules [0, i). Two modules with dividers a and b coincide if their
+     * phases are equal modulo gcd(a, b).
+     */
+    uint8_t findPhase(uint8_t i) const {
+      const Task& task = mTasks[i];
+      uint8_t bestPhase = 0;
+      uint8_t bestCollisions = UINT8_MAX;
+      for (uint8_t phase = 0; phase < task.divider; phase++) {
+        uint8_t collisions = 0;
+        for (uint8_t j = 0; j < i; j++) {
+          const Task& other = mTasks[j];
+          uint8_t g = gcd(task.divider, other.divider);
+          if ((phase % g) == (other.phase % g)) collisions++;
+        }
+        if (collisions < bestCollisions) {
+          bestCollisions = collisions;
+          bestPhase = phase;
+          if (collisions == 0) break;
+        }
+      }
+      return bestPhase;
+    }
+
+    /** Render the modules which are due on this tick. */
+    void tick() {
+      for (uint8_t i = 0; i < mNumModules; i++) {
+        Task& task = mTasks[i];
+        if (task.counter != 0) {
+          task.counter--;
+          continue;
+        }
+        task.counter = task.divider - 1;
+
+        uint16_t nowMicros = T_CI::micros();
+        if (task.hasLastMicros) {
+          uint16_t elapsed = (uint16_t) (nowMicros - task.lastMicros);
+          if (elapsed < task.minFieldMicros) task.minFieldMicros = elapsed;
+          if (elapsed > task.maxFieldMicros) task.maxFieldMicros = elapsed;
+        }
+        task.lastMicros = nowMicros;
+        task.hasLastMicros = true;
+
+        task.render(task.module);
+      }
+    }
+
+    // disable copy-constructor and assignment operator
+    ScanningScheduler(const ScanningScheduler&) = delete;
+    ScanningScheduler& operator=(const ScanningScheduler&) = delete;
+
+  private:
+    /** The scheduler called by isr(). */
+    static ScanningScheduler* volatile sScheduler;
+
+    Task mTasks[T_MAX_MODULES];
+    uint16_t const mMinMicrosPerTick;
+    uint16_t mMicrosPerTick = 0;
+    uint8_t mNumModules = 0;
+};
+
+template <typename T_TI, uint8_t T_MAX_MODULES, typename T_CI>
+ScanningScheduler<T_TI, T_MAX_MODULES, T_CI>* volatile
+ScanningScheduler<T_TI, T_MAX_MODULES, T_CI>::sScheduler = nullptr;
+
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_SCANNING_TIMER_H
+#define ACE_SEGMENT_SCANNING_TIMER_H
+
+#include <stdint.h>
+#include <Arduino.h> // noInterrupts(), interrupts()
+#include "../hw/TimerInterface.h"
+
+namespace ace_segment {
+
+/**
+ * Drive the renderFieldNow() method of a ScanningModule from a periodic timer
+ * interrupt provided by `T_TI`. The period of the timer is programmed from
+ * ScanningModule::getMicrosPerField(), and reprogrammed by
+ * setFramesPerSecond(), or by sync() if the module was reconfigured directly.
+ * The isr() also compares the period after each field, so that a period
+ * changed by the module itself (e.g. kBlankPolicyLowerRate, which recomputes
+ * it when the scan set changes at the start of a frame) is applied from the
+ * next field.
+ *
+ * The field period of the module and the programmed period are 16-bit values
+ * which are also written by the isr(), so the methods called from the main
+ * code (setFramesPerSecond(), sync(), getMicrosPerField()) access them with
+ * interrupts disabled. They must not be called from another interrupt.
+ *
+ * The interrupt service routine must be a plain function, so the module is
+ * stored in a static variable. Only one ScanningTimer can be active for a
+ * given combination of `T_MODULE` and `T_TI`.
+ *
+ * @tparam T_MODULE the ScanningModule (or a subclass like Hc595Module)
+ * @tparam T_TI class that implements the TimerInterface static methods
+ */
+template <typename T_MODULE, typename T_TI = TimerInterface>
+class ScanningTimer {
+  public:
+    /** Constructor. */
+    explicit ScanningTimer(T_MODULE& module) :
+        mModule(module)
+    {}
+
+    /**
+     * Start the timer. The module must be initialized separately, before this
+     * is called.
+     */
+    void begin() {
+      sModule = &mModule;
+      sMicrosPerField = mModule.getMicrosPerField();
+      T_TI::begin(sMicrosPerField, isr);
+    }
+
+    /** Stop the timer. */
+    void end() {
+      T_TI::end();
+      sModule = nullptr;
+    }
+
+    /** Change the frame rate of the module, and reprogram the timer. */
+    void setFramesPerSecond(uint8_t framesPerSecond) {
+      noInterrupts();
+      mModule.setFramesPerSecond(framesPerSecond);
+      syncPeriod(mModule);
+      interrupts();
+    }
+
+    /**
+     * Reprogram the timer if the getMicrosPerField() of the module has changed
+     * since the timer was last programmed. Return true if the timer was
+     * reprogrammed.
+     */
+    bool sync() {
+      noInterrupts();
+      bool changed = syncPeriod(mModule);
+      interrupts();
+      return changed;
+    }
+
+    /** Return the period currently programmed into the timer. */
+    uint16_t getMicrosPerField() const {
+      noInterrupts();
+      uint16_t micros = sMicrosPerField;
+      interrupts();
+      return micros;
+    }
+
+  private:
+    /**
+     * The interrupt service routine. Render one field, then reprogram the
+     * timer if the field period of the module changed.
+     */
+    static void isr() {
+      T_MODULE* module = sModule;
+      if (module) {
+        module->renderFieldNow();
+        syncPeriod(*module);
+      }
+    }
+
+    /**
+     * Reprogram the timer if getMicrosPerField() of the module differs from
+     * the programmed period. Called from the isr(), or from the main code with
+     * interrupts disabled.
+     */
+    static bool syncPeriod(const T_MODULE& module) {
+      uint16_t micros = module.getMicrosPerField();
+      if (micros == sMicrosPerField) return false;
+
+      sMicrosPerField = micros;
+      T_TI::setPeriod(micros);
+      return true;
+    }
+
+    // disable copy-constructor and assignment operator
+    ScanningTimer(const ScanningTimer&) = delete;
+    ScanningTimer& operator=(const ScanningTimer&) = delete;
+
+  private:
+    /** The module rendered by isr(). */
+    static T_MODULE* volatile sModule;
+
+    /** Period programmed into the timer, shared with isr(). */
+    static volatile uint16_t sMicrosPerField;
+
+    T_MODULE& mModule;
+};
+
+template <typename T_MODULE, typename T_TI>
+T_MODULE* volatile ScanningTimer<T_MODULE, T_TI>::sModule = nullptr;
+
+template <typename T_MODULE, typename T_TI>
+volatile uint16_t ScanningTimer<T_MODULE, T_TI>::sMicrosPerField = 0;
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_SCAN_ORDER_H
+#define ACE_SEGMENT_SCAN_ORDER_H
+
+#include <stdint.h>
+#include <Arduino.h> // PROGMEM, pgm_read_byte()
+#include "../index_list.h" // IndexList, MakeIndexList
+
+namespace ace_segment {
+namespace internal {
+
+/**
+ * Return the i-th element of the interleaved order of n items: the even items
+ * first, then the odd items, e.g. "0 2 4 1 3" for n = 5. Adjacent items are
+ * separated by about n/2 positions.
+ */
+constexpr uint8_t interleavedIndex(uint8_t i, uint8_t n) {
+  return (i < (n + 1) / 2) ? 2 * i : 2 * (i - (n + 1) / 2) + 1;
+}
+
+/** Return the number of bits needed to hold the values [0, n-1]. */
+constexpr uint8_t numBitsFor(uint8_t n) {
+  return (n <= 1) ? 0 : 1 + numBitsFor((n + 1) / 2);
+}
+
+/** Reverse the lower numBits of j. */
+constexpr uint8_t reverseBits(uint16_t j, uint8_t numBits) {
+  return (numBits == 0)
+      ? 0
+      : ((j & 0x1) << (numBits - 1)) | reverseBits(j >> 1, numBits - 1);
+}
+
+/**
+ * Return the i-th element of the bit-reversed order of n items, skipping the
+ * values >= n, e.g. "0 4 2 1 3" for n = 5. The first k elements of this
+ * sequence are spread evenly across the sequence, for any k.
+ */
+constexpr uint8_t spreadIndex(uint8_t i, uint8_t n, uint16_t j = 0) {
+  return (reverseBits(j, numBitsFor(n)) >= n)
+      ? spreadIndex(i, n, j + 1)
+      : (i == 0)
+          ? reverseBits(j, numBitsFor(n))
+          : spreadIndex(i - 1, n, j + 1);
+}
+
+/**
+ * A table of N elements, computed at compile-time, which holds the
+ * interleavedIndex() sequence, or the spreadIndex() sequence if T_SPREAD is
+ * true. The table is stored in flash (PROGMEM), so it uses no static RAM on
+ * AVR, and must be read using valueAt().
+ */
+template <
+    uint8_t N,
+    bool T_SPREAD,
+    typename T_INDEXES = typename MakeIndexList<N>::type>
+struct ScanOrderTable;
+
+template <uint8_t N, bool T_SPREAD, uint8_t... Is>
+struct ScanOrderTable<N, T_SPREAD, IndexList<Is...>> {
+  static const uint8_t kValues[N];
+
+  /** Return the i-th element of the table. */
+  static uint8_t valueAt(uint8_t i) {
+    return pgm_read_byte(&kValues[i]);
+  }
+};
+
+template <uint8_t N, bool T_SPREAD, uint8_t... Is>
+const uint8_t ScanOrderTable<N, T_SPREAD, IndexList<Is...>>::kValues[N]
+PROGMEM = {
+  (T_SPREAD ? spreadIndex(Is, N) : interleavedIndex(Is, N))...
+};
+
+/**
+ * Map the position i to T_TABLE::valueAt(i) if T_ENABLED, otherwise return i
+ * unchanged. This is a specialization instead of a ternary expression, so that
+ * a disabled scan order does not instantiate (and store) its table.
+ */
+template <bool T_ENABLED, typename T_TABLE>
+struct ScanOrder {
+  static uint8_t at(uint8_t i) { return i; }
+};
+
+template <typename T_TABLE>
+struct ScanOrder<true, T_TABLE> {
+  static uint8_t at(uint8_t i) { return T_TABLE::valueAt(i); }
+};
+
+} // namespace internal
+} // namespace ace_segment
+
+#endif
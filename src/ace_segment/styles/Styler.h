@@ -0,0 +1,215 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_STYLER_H
+#define ACE_SEGMENT_STYLER_H
+
+#include <stdint.h>
+
+class StylerTest_update;
+
+namespace ace_segment {
+
+/** Style type which leaves the digit unchanged. */
+const uint8_t kStyleTypeNone = 0;
+
+/** Style type which turns the digit on and off with a 50% duty cycle. */
+const uint8_t kStyleTypeBlink = 1;
+
+/**
+ * Style type which ramps the brightness of the digit up and down. Requires
+ * per-digit brightness, so it is supported only by a ScanningModule with
+ * T_SUBFIELDS > 1. Controller modules ignore this style.
+ */
+const uint8_t kStyleTypePulse = 2;
+
+/**
+ * An entry in a style table. The table is normally a constexpr array, for
+ * example:
+ *
+ * @code{.cpp}
+ * constexpr Style STYLES[] = {
+ *   {kStyleTypeBlink, 1000},
+ *   {kStyleTypePulse, 2000},
+ * };
+ * @endcode
+ */
+struct Style {
+  /** One of the kStyleTypeXxx constants. */
+  uint8_t type;
+
+  /** Duration of one full cycle of the effect in millis. */
+  uint16_t periodMillis;
+};
+
+/**
+ * A frame-level effects engine which applies the styles of a style table to
+ * the digits of an LedModule, without rewriting the patterns of the module.
+ * Each digit is assigned a style ID, where 0 means no style, and ID `i` in the
+ * range [1, 3] selects `styles[i-1]` of the style table. The IDs are packed
+ * into 2 bits per digit for up to 8 digits.
+ *
+ * The LedModule calls update() once per frame (ScanningModule) or once per
+ * flush (controller modules) to evaluate each style in the table, and then
+ * applyPattern() or applyBrightness() for each digit, which is a single table
+ * lookup. The update() returns the digits whose visible pattern changed, so
+ * that the module can mark them dirty.
+ *
+ * This class is not thread-safe. If the module is rendered from an ISR, the
+ * calls to setStyleAt() must be protected with noInterrupts().
+ */
+class Styler {
+  public:
+    /** Number of style IDs, including the reserved ID 0 for "no style". */
+    static const uint8_t kNumStyles = 4;
+
+    /** Maximum number of digits supported. */
+    static const uint8_t kMaxDigits = 8;
+
+    /**
+     * Constructor.
+     * @param styles array of Style, usually a constexpr table
+     * @param numStyles number of entries in styles, at most kNumStyles - 1
+     */
+    explicit Styler(const Style* styles, uint8_t numStyles) :
+        mStyles(styles),
+        mNumStyles(numStyles < kNumStyles ? numStyles : kNumStyles - 1)
+    {}
+
+    /** Reset all digits to style 0, and all styles to fully on. */
+    void begin() {
+      mStyleIds = 0;
+      mPendingDigits = 0;
+      mOnBits = 0xFF;
+      for (uint8_t i = 0; i < kNumStyles; i++) {
+        mLevels[i] = 255;
+      }
+    }
+
+    /** Set the style ID of the digit at pos. */
+    void setStyleAt(uint8_t pos, uint8_t styleId) {
+      if (pos >= kMaxDigits || styleId > mNumStyles) return;
+
+      uint8_t shift = pos * 2;
+      mStyleIds = (mStyleIds & ~(0x3 << shift))
+          | ((uint16_t) styleId << shift);
+      mPendingDigits |= (0x1 << pos);
+    }
+
+    /** Get the style ID of the digit at pos. */
+    uint8_t getStyleAt(uint8_t pos) const {
+      return (mStyleIds >> (pos * 2)) & 0x3;
+    }
+
+    /**
+     * Evaluate each style of the table at the given time. Return the bit mask
+     * of the digits whose visible pattern changed since the previous call,
+     * including the digits whose style ID was changed by setStyleAt().
+     */
+    uint8_t update(uint32_t nowMillis) {
+      uint8_t onBits = 0x1; // style 0 is always on
+      for (uint8_t i = 0; i < mNumStyles; i++) {
+        const Style& style = mStyles[i];
+        const uint8_t id = i + 1;
+        uint16_t period = style.periodMillis;
+        uint16_t phase = (period == 0) ? 0 : nowMillis % period;
+        uint16_t half = period / 2;
+
+        if (style.type == kStyleTypeBlink) {
+          if (phase < half || period == 0) onBits |= (0x1 << id);
+          mLevels[id] = 255;
+        } else if (style.type == kStyleTypePulse) {
+          onBits |= (0x1 << id);
+          uint16_t ramp = (phase < half) ? phase : period - phase;
+          // An odd period has one more step on the way down, so that the ramp
+          // at the peak is half + 1, which must not exceed 255.
+          if (ramp > half) ramp = half;
+          mLevels[id] = (half == 0) ? 255 : (uint32_t) ramp * 255 / half;
+        } else {
+          onBits |= (0x1 << id);
+          mLevels[id] = 255;
+        }
+      }
+
+      uint8_t changedStyles = onBits ^ mOnBits;
+      mOnBits = onBits;
+
+      uint8_t changedDigits = mPendingDigits;
+      mPendingDigits = 0;
+      if (changedStyles) {
+        uint16_t ids = mStyleIds;
+        for (uint8_t pos = 0; pos < kMaxDigits; pos++) {
+          if (changedStyles & (0x1 << (ids & 0x3))) {
+            changedDigits |= (0x1 << pos);
+          }
+          ids >>= 2;
+        }
+      }
+      return changedDigits;
+    }
+
+    /** Return the pattern of the digit at pos after applying its style. */
+    uint8_t applyPattern(uint8_t pos, uint8_t pattern) const {
+      return (mOnBits & (0x1 << getStyleAt(pos))) ? pattern : 0;
+    }
+
+    /**
+     * Return the brightness of the digit at pos after applying its style.
+     * The result is in the same units as the given brightness.
+     */
+    uint8_t applyBrightness(uint8_t pos, uint8_t brightness) const {
+      uint8_t level = mLevels[getStyleAt(pos)];
+      return ((uint16_t) brightness * level + 127) / 255;
+    }
+
+  private:
+    friend class ::StylerTest_update;
+
+    // disable copy-constructor and assignment operator
+    Styler(const Styler&) = delete;
+    Styler& operator=(const Styler&) = delete;
+
+  private:
+    /** Style table, indexed by style ID - 1. */
+    const Style* const mStyles;
+
+    /** Number of entries in mStyles. */
+    uint8_t const mNumStyles;
+
+    /** Style ID of each digit, 2 bits per digit. */
+    uint16_t mStyleIds;
+
+    /** Digits whose style ID changed since the last update(). */
+    uint8_t mPendingDigits;
+
+    /** Bit i is set if style ID i currently shows the pattern. */
+    uint8_t mOnBits;
+
+    /** Brightness level [0, 255] of each style ID. */
+    uint8_t mLevels[kNumStyles];
+};
+
+} // ace_segment
+
+#endif
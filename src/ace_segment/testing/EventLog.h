@@ -34,23 +34,30 @@ namespace testing {
 enum class EventType : uint8_t {
   kDigitalWrite,
   kPinMode,
+  kAnalogWrite,
+  kDigitalRead,
   // SpiInterface
   kSpiBegin,
   kSpiEnd,
   kSpiSend8,
   kSpiSend16,
+  kSpiBeginTransaction,
+  kSpiEndTransaction,
+  kSpiTransfer,
   // Tmi1637Interface
   kTmi1637Begin,
   kTmi1637End,
   kTmi1637StartCondition,
   kTmi1637StopCondition,
   kTmi1637SendByte,
+  kTmi1637ReadByte,
   // Tmi1638Interface
   kTmi1638Begin,
   kTmi1638End,
   kTmi1638BeginTransaction,
   kTmi1638EndTransaction,
   kTmi1638Write,
+  kTmi1638Read,
   // WireInterface
   kWireBegin,
   kWireEnd,
@@ -62,6 +69,7 @@ enum class EventType : uint8_t {
   kLedMatrixEnableGroup,
   kLedMatrixDisableGroup,
   kLedMatrixClear,
+  kLedMatrixDrawBanks,
 };
 
 /** A record of one Hardware event. */
@@ -97,6 +105,26 @@ class EventLog {
       mNumRecords++;
     }
 
+    void addDigitalRead(uint8_t pin, uint8_t value) {
+      if (mNumRecords >= kMaxRecords) return;
+
+      Event& event = mEvents[mNumRecords];
+      event.type = EventType::kDigitalRead;
+      event.arg1 = pin;
+      event.arg2 = value;
+      mNumRecords++;
+    }
+
+    void addAnalogWrite(uint8_t pin, uint8_t value) {
+      if (mNumRecords >= kMaxRecords) return;
+
+      Event& event = mEvents[mNumRecords];
+      event.type = EventType::kAnalogWrite;
+      event.arg1 = pin;
+      event.arg2 = value;
+      mNumRecords++;
+    }
+
     //-------------------------------------------------------------------------
 
     void addSpiBegin() {
@@ -133,6 +161,31 @@ class EventLog {
       mNumRecords++;
     }
 
+    void addSpiBeginTransaction() {
+      if (mNumRecords >= kMaxRecords) return;
+
+      Event& event = mEvents[mNumRecords];
+      event.type = EventType::kSpiBeginTransaction;
+      mNumRecords++;
+    }
+
+    void addSpiEndTransaction() {
+      if (mNumRecords >= kMaxRecords) return;
+
+      Event& event = mEvents[mNumRecords];
+      event.type = EventType::kSpiEndTransaction;
+      mNumRecords++;
+    }
+
+    void addSpiTransfer(uint8_t value) {
+      if (mNumRecords >= kMaxRecords) return;
+
+      Event& event = mEvents[mNumRecords];
+      event.type = EventType::kSpiTransfer;
+      event.arg1 = value;
+      mNumRecords++;
+    }
+
     //-------------------------------------------------------------------------
 
     void addTmi1637Begin() {
@@ -176,6 +229,15 @@ class EventLog {
       mNumRecords++;
     }
 
+    void addTmi1637ReadByte(uint8_t data) {
+      if (mNumRecords >= kMaxRecords) return;
+
+      Event& event = mEvents[mNumRecords];
+      event.type = EventType::kTmi1637ReadByte;
+      event.arg1 = data;
+      mNumRecords++;
+    }
+
     //-------------------------------------------------------------------------
 
     void addTmi1638Begin() {
@@ -219,6 +281,15 @@ class EventLog {
       mNumRecords++;
     }
 
+    void addTmi1638Read(uint8_t data) {
+      if (mNumRecords >= kMaxRecords) return;
+
+      Event& event = mEvents[mNumRecords];
+      event.type = EventType::kTmi1638Read;
+      event.arg1 = data;
+      mNumRecords++;
+    }
+
     //-------------------------------------------------------------------------
 
     void addWireBegin() {
@@ -246,11 +317,13 @@ class EventLog {
       mNumRecords++;
     }
 
-    void addWireEndTransmission() {
+    /** The sendStop flag is stored in arg1, but not checked by assertEvents(). */
+    void addWireEndTransmission(bool sendStop = true) {
       if (mNumRecords >= kMaxRecords) return;
 
       Event& event = mEvents[mNumRecords];
       event.type = EventType::kWireEndTransmission;
+      event.arg1 = sendStop;
       mNumRecords++;
     }
 
@@ -301,6 +374,18 @@ class EventLog {
       mNumRecords++;
     }
 
+    void addLedMatrixDrawBanks(
+        uint8_t group, uint8_t elementPatternA, uint8_t elementPatternB) {
+      if (mNumRecords >= kMaxRecords) return;
+
+      Event& event = mEvents[mNumRecords];
+      event.type = EventType::kLedMatrixDrawBanks;
+      event.arg1 = group;
+      event.arg2 = elementPatternA;
+      event.arg3 = elementPatternB;
+      mNumRecords++;
+    }
+
     //-------------------------------------------------------------------------
 
     uint8_t getNumRecords() { return mNumRecords; }
@@ -342,6 +427,22 @@ class EventLog {
             }
             break;
 
+          case EventType::kDigitalRead: {
+              uint8_t pin = va_arg(args, int);
+              uint8_t value = va_arg(args, int);
+              if (pin != event.arg1) return false;
+              if (value != event.arg2) return false;
+            }
+            break;
+
+          case EventType::kAnalogWrite: {
+              uint8_t pin = va_arg(args, int);
+              uint8_t value = va_arg(args, int);
+              if (pin != event.arg1) return false;
+              if (value != event.arg2) return false;
+            }
+            break;
+
           //------------------------------------------------------------------
 
           case EventType::kSpiBegin:
@@ -362,6 +463,18 @@ class EventLog {
             }
             break;
 
+          case EventType::kSpiBeginTransaction:
+            break;
+
+          case EventType::kSpiEndTransaction:
+            break;
+
+          case EventType::kSpiTransfer: {
+              uint8_t value = va_arg(args, int);
+              if (value != event.arg1) return false;
+            }
+            break;
+
           //------------------------------------------------------------------
 
           case EventType::kTmi1637Begin:
@@ -382,6 +495,12 @@ class EventLog {
             }
             break;
 
+          case EventType::kTmi1637ReadByte: {
+              uint8_t value = va_arg(args, int);
+              if (value != event.arg1) return false;
+            }
+            break;
+
           //------------------------------------------------------------------
 
           case EventType::kTmi1638Begin:
@@ -402,6 +521,12 @@ class EventLog {
             }
             break;
 
+          case EventType::kTmi1638Read: {
+              uint8_t value = va_arg(args, int);
+              if (value != event.arg1) return false;
+            }
+            break;
+
           //------------------------------------------------------------------
 
           case EventType::kWireBegin:
@@ -449,6 +574,16 @@ class EventLog {
 
           case EventType::kLedMatrixClear:
             break;
+
+          case EventType::kLedMatrixDrawBanks: {
+              uint8_t group = va_arg(args, int);
+              uint8_t elementPatternA = va_arg(args, int);
+              uint8_t elementPatternB = va_arg(args, int);
+              if (group != event.arg1) return false;
+              if (elementPatternA != event.arg2) return false;
+              if (elementPatternB != event.arg3) return false;
+            }
+            break;
         }
       }
       va_end(args);
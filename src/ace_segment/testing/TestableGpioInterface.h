@@ -39,6 +39,15 @@ class TestableGpioInterface {
     static void digitalWrite(uint8_t pin, uint8_t value) {
       gEventLog.addDigitalWrite(pin, value);
     }
+
+    static uint8_t digitalRead(uint8_t pin) {
+      gEventLog.addDigitalRead(pin, sReadValue);
+      return sReadValue;
+    }
+
+  public:
+    /** Value returned by digitalRead(), for all pins. */
+    static uint8_t sReadValue;
 };
 
 }
@@ -14,6 +14,8 @@ namespace testing {
 
 class TestableLedMatrix {
   public:
+    static const bool kHasBrightness = false;
+
     void draw(uint8_t group, uint8_t elementPattern) const {
       mEventLog.addLedMatrixDraw(group, elementPattern);
     }
@@ -30,8 +32,20 @@ class TestableLedMatrix {
       mEventLog.addLedMatrixClear();
     }
 
+    void drawBanks(
+        uint8_t group, uint8_t elementPatternA, uint8_t elementPatternB) const {
+      mEventLog.addLedMatrixDrawBanks(group, elementPatternA, elementPatternB);
+    }
+
+    void setBrightness(uint8_t /*brightness*/) const {}
+
+    uint16_t getKeyBits() const { return mKeyBits; }
+
   public:
     mutable EventLog mEventLog;
+
+    /** Keys returned by getKeyBits(), 1 meaning pressed. */
+    uint16_t mKeyBits = 0;
 };
 
 }
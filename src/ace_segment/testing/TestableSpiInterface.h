@@ -28,6 +28,18 @@ class TestableSpiInterface {
       uint16_t value = ((uint16_t) msb) << 8 | (uint16_t) lsb;
       send16(value);
     }
+
+    void beginTransaction() const {
+      gEventLog.addSpiBeginTransaction();
+    }
+
+    void endTransaction() const {
+      gEventLog.addSpiEndTransaction();
+    }
+
+    void transfer(uint8_t value) const {
+      gEventLog.addSpiTransfer(value);
+    }
 };
 
 } // testing
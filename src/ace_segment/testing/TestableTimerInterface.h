@@ -0,0 +1,90 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_TESTABLE_TIMER_INTERFACE_H
+#define ACE_SEGMENT_TESTABLE_TIMER_INTERFACE_H
+
+#include <stdint.h>
+#include "../hw/TimerInterface.h"
+#include "TestableClockInterface.h"
+
+namespace ace_segment {
+namespace testing {
+
+/**
+ * A fake implementation of TimerInterface which fires simulated interrupts
+ * when the unit test advances the time. The clock of TestableClockInterface is
+ * advanced along with the timer, so that the isr sees a consistent micros().
+ */
+class TestableTimerInterface {
+  public:
+    static void begin(uint32_t periodMicros, TimerIsr isr) {
+      sPeriodMicros = periodMicros;
+      sIsr = isr;
+      sElapsedMicros = 0;
+      sNumInterrupts = 0;
+    }
+
+    static void setPeriod(uint32_t periodMicros) {
+      sPeriodMicros = periodMicros;
+      sNumPeriodChanges++;
+    }
+
+    static void end() {
+      sIsr = nullptr;
+    }
+
+    /**
+     * Advance the time by the given micros, calling the isr once for each
+     * full period that elapsed.
+     */
+    static void advanceMicros(uint32_t micros) {
+      while (micros > 0) {
+        uint32_t remaining = sPeriodMicros - sElapsedMicros;
+        if (sIsr == nullptr || sPeriodMicros == 0 || micros < remaining) {
+          sElapsedMicros += micros;
+          TestableClockInterface::sMicros += micros;
+          return;
+        }
+
+        micros -= remaining;
+        sElapsedMicros = 0;
+        TestableClockInterface::sMicros += remaining;
+        sNumInterrupts++;
+        sIsr();
+      }
+    }
+
+  public:
+    static TimerIsr sIsr;
+    static uint32_t sPeriodMicros;
+    static uint32_t sElapsedMicros;
+    static uint16_t sNumInterrupts;
+    static uint16_t sNumPeriodChanges;
+};
+
+} // namespace testing
+} // namespace ace_segment
+
+#endif
@@ -28,6 +28,16 @@ class TestableTmi1637Interface {
       gEventLog.addTmi1637SendByte(data);
       return 0;
     }
+
+    /** Return sReadData, which can be set by the unit test. */
+    uint8_t read() const {
+      gEventLog.addTmi1637ReadByte(sReadData);
+      return sReadData;
+    }
+
+  public:
+    /** The byte returned by read(). 0xFF means that no button is pressed. */
+    static uint8_t sReadData;
 };
 
 } // testing
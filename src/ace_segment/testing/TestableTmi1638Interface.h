@@ -18,6 +18,7 @@ class TestableTmi1638Interface {
 
     void beginTransaction() const {
       gEventLog.addTmi1638BeginTransaction();
+      sReadIndex = 0;
     }
 
     void endTransaction() const {
@@ -28,6 +29,24 @@ class TestableTmi1638Interface {
       gEventLog.addTmi1638Write(data);
       return 0;
     }
+
+    /**
+     * Return the next byte of sReadData, least significant byte first, which
+     * can be set by the unit test.
+     */
+    uint8_t read() const {
+      uint8_t data = (uint8_t) (sReadData >> (8 * sReadIndex));
+      sReadIndex = (sReadIndex + 1) & 0x3;
+      gEventLog.addTmi1638Read(data);
+      return data;
+    }
+
+  public:
+    /** The 4 bytes returned by successive calls to read(). */
+    static uint32_t sReadData;
+
+    /** Index of the next byte of sReadData returned by read(). */
+    static uint8_t sReadIndex;
 };
 
 } // testing
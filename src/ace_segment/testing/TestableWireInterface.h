@@ -29,8 +29,7 @@ class TestableWireInterface {
     }
 
     void endTransmission(bool sendStop = true) const {
-      (void) sendStop; // disable compiler warning
-      gEventLog.addWireEndTransmission();
+      gEventLog.addWireEndTransmission(sendStop);
     }
 };
 
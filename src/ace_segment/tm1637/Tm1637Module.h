@@ -25,12 +25,18 @@ SOFTWARE.
 #ifndef ACE_SEGMENT_TM1637_MODULE_H
 #define ACE_SEGMENT_TM1637_MODULE_H
 
-#include <string.h> // memset()
 #include <AceCommon.h> // incrementMod()
+#include "../hw/ClockInterface.h" // ClockInterface
+#include "../hw/remap.h"
 #include "../LedModule.h"
 
 class Tm1637ModuleTest_flushIncremental;
+class Tm1637ModuleTest_flushIncremental_wrapsAround;
 class Tm1637ModuleTest_flush;
+class Tm1637ModuleTest_flushFor;
+class Tm1637ModuleTest_flushBurst;
+class Tm1637ModuleTest_flushBurst_remap;
+class Tm1637ModuleTest_flushBurst_brightness;
 
 namespace ace_segment {
 
@@ -62,33 +68,74 @@ static const uint16_t kDefaultTm1637DelayMicros = 100;
 extern const uint8_t kDigitRemapArray6Tm1637[6];
 
 /**
- * An implementation of LedModule using the TM1637 chip. The chip communicates
- * using a protocol that is electrically similar to I2C, but does not use an
- * address byte at the beginning of the protocol.
+ * The compile-time version of kDigitRemapArray6Tm1637, to be passed as the
+ * T_REMAP template parameter of Tm1637Module.
+ */
+using DigitRemap6Tm1637 = RemapSequence<2, 1, 0, 5, 4, 3>;
+
+/**
+ * Relative costs of the TM1637 wire protocol, used by flushBurst() to choose
+ * between a full flush and sending only the runs of dirty digits. A
+ * transaction is a start/stop pair. Only the ratio matters.
+ *
+ * The default values were calibrated from the AutoBenchmark results at a
+ * 100 us bit delay: flush() (7 bytes in 3 transactions) takes about 22.3 ms,
+ * and the brightness stage of flushIncremental() (1 byte in 1 transaction)
+ * takes about 3.6 ms. Solving gives about 2.9 ms per byte and 0.7 ms per
+ * transaction, a ratio of about 4:1. The results at a 5 us bit delay give
+ * the same ratio.
+ *
+ * Every TM1637 transaction starts with exactly one command byte, so the cost
+ * of processing a command cannot be separated from the cost of a transaction
+ * in these measurements, and is included in kCostTransaction.
+ *
+ * Specialize this template for a custom T_TMII whose timing is different.
+ */
+template <typename T_TMII>
+struct Tm1637CostTraits {
+  /** Cost of sending one byte, including its ACK bit. */
+  static uint8_t const kCostByte = 4;
+
+  /** Cost of the start and stop conditions of one transaction. */
+  static uint8_t const kCostTransaction = 1;
+};
+
+/**
+ * The part of Tm1637Module which does not depend on the number of digits. All
+ * of the flushing and button logic lives here, using the getNumDigits() of
+ * the LedModule instead of a template parameter, so that modules with
+ * different numbers of digits on the same interface share a single copy of
+ * this code in flash. The Tm1637Module subclass adds only the pattern array.
  *
  * @tparam T_TMII class that implements the two wire protocol interface for
  *    TM1637, usually one of the classes from the AceTMI library:
  *    SimpleTmi1637Interface or SimpleTmi1637FastInterface.
- * @tparam T_DIGITS number of digits in the LED module (usually 4 or 6)
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()), used by flushFor().
+ * @tparam T_REMAP class that remaps the logical digit positions to their
+ *    physical positions, RemapArray or a RemapSequence
  */
-template <typename T_TMII, uint8_t T_DIGITS>
-class Tm1637Module : public LedModule {
+template <typename T_TMII, typename T_CI, typename T_REMAP>
+class Tm1637ModuleBase : public LedModule, private T_REMAP {
   public:
 
     /**
      * Constructor.
      * @param tmiInterface instance of TM1637 interface class
-     * @param remapArray (optional, nullable) a mapping of the logical digit
-     *    positions to their physical positions, useful for 6-digt LED modules
-     *    whose digits are wired out of order
+     * @param patterns array of segment patterns, one for each digit
+     * @param numDigits number of digits in the LED module
+     * @param remapArray (nullable) a mapping of the logical digit positions to
+     *    their physical positions
      */
-    explicit Tm1637Module(
+    explicit Tm1637ModuleBase(
         const T_TMII& tmiInterface,
-        const uint8_t* remapArray = nullptr
+        uint8_t* patterns,
+        uint8_t numDigits,
+        typename T_REMAP::Argument remapArray
     ) :
-        LedModule(mPatterns, T_DIGITS),
-        mTmiInterface(tmiInterface),
-        mRemapArray(remapArray)
+        LedModule(patterns, numDigits),
+        T_REMAP(remapArray),
+        mTmiInterface(tmiInterface)
     {}
 
     //-----------------------------------------------------------------------
@@ -102,9 +149,10 @@ class Tm1637Module : public LedModule {
     void begin() {
       LedModule::begin();
 
-      memset(mPatterns, 0, T_DIGITS);
+      clearPatterns();
       setDisplayOn(true);
       mFlushStage = 0;
+      mStepPos = kStepDone;
     }
 
     /** Signal end of usage. Currently does nothing. */
@@ -134,6 +182,17 @@ class Tm1637Module : public LedModule {
       return isAnyDigitDirty() || isBrightnessDirty();
     }
 
+    /**
+     * Return the number of micros until flushIncremental() has work to do: 0
+     * if a stage is pending, otherwise kMicrosNoDeadline. A low-power loop()
+     * can combine this with the deadlines of its other tasks to decide how
+     * long to sleep. A Styler is evaluated only by the flush methods, so its
+     * effects require a periodic flush regardless of this deadline.
+     */
+    uint32_t getMicrosUntilNextFlush() const {
+      return isFlushRequired() ? 0 : kMicrosNoDeadline;
+    }
+
     /**
      * Send segment patterns of all digits plus the brightness to the display.
      * Takes about 22 ms using a 100 microsecond delay.
@@ -142,44 +201,95 @@ class Tm1637Module : public LedModule {
      * to flush(), but often it is not necessary.
      */
     void flush() {
-      // Command1: Update the digits using auto incrementing mode.
-      mTmiInterface.startCondition();
-      mTmiInterface.write(kDataCmdAutoAddress);
-      mTmiInterface.stopCondition();
+      if (getStyler()) updateStyler(T_CI::millis());
+      writeAll();
+    }
 
-      // Command2: Send the LED patterns.
-      mTmiInterface.startCondition();
-      mTmiInterface.write(kAddressCmd);
-      for (uint8_t chipPos = 0; chipPos < T_DIGITS; ++chipPos) {
-        // Remap the logical position used by the controller to the actual
-        // position. For example, if the controller digit 0 appears at physical
-        // digit 2, we need to display the segment pattern given by logical
-        // position 2 when sending the byte to controller digit 0.
-        uint8_t physicalPos = remapLogicalToPhysical(chipPos);
-        uint8_t effectivePattern = mPatterns[physicalPos];
-        mTmiInterface.write(effectivePattern);
-      }
-      mTmiInterface.stopCondition();
+    /**
+     * Send only the dirty digits, grouping adjacent dirty chip positions (after
+     * remapping) into runs which are sent using the auto incrementing address
+     * mode, so that each run costs only one start/stop pair. The brightness is
+     * sent only if it is dirty.
+     *
+     * The cost of the runs is compared against the cost of a full flush() using
+     * the byte and transaction costs of Tm1637CostTraits. If the runs are not
+     * cheaper (e.g. most digits are dirty, or the dirty digits are
+     * scattered), then everything is sent as in flush() instead.
+     *
+     * Sending the same dirty set using flushIncremental() is never cheaper in
+     * total: each dirty digit costs 2 transactions and 3 bytes, while a run
+     * costs 1 transaction and 1 byte plus 1 byte per digit, after a single
+     * data command. Use flushIncremental() or flushFor() instead when the
+     * latency of a single call matters more than the total time.
+     */
+    void flushBurst() {
+      if (getStyler()) updateStyler(T_CI::millis());
+      const uint8_t numDigits = getNumDigits();
+      const uint8_t dirtyChipBits =
+          (uint8_t) (getDirtyStageBits() & ((1U << numDigits) - 1));
+
+      if (dirtyChipBits) {
+        uint8_t numDirty = 0;
+        uint8_t numRuns = 0;
+        bool prevDirty = false;
+        for (uint8_t chipPos = 0; chipPos < numDigits; ++chipPos) {
+          bool dirty = dirtyChipBits & (1 << chipPos);
+          if (dirty) {
+            numDirty++;
+            if (! prevDirty) numRuns++;
+          }
+          prevDirty = dirty;
+        }
 
-      // Command3: Update the brightness last. This matches the recommendation
-      // given in the Titan Micro TM1637 datasheet. But experimentation shows
-      // that things seems to work even if brightness is sent first, before the
-      // digit patterns.
-      mTmiInterface.startCondition();
-      mTmiInterface.write(kBrightnessCmd
-          | (mDisplayOn ? kBrightnessLevelOn : 0x0)
-          | (getBrightness() & 0xF));
-      mTmiInterface.stopCondition();
+        if (burstCost(numRuns, numDirty) >= fullFlushCost()) {
+          writeAll();
+          return;
+        }
 
-      clearDigitsDirty();
-      clearBrightnessDirty();
+        // Command1: Update the digits using auto incrementing mode.
+        mTmiInterface.startCondition();
+        mTmiInterface.write(kDataCmdAutoAddress);
+        mTmiInterface.stopCondition();
+
+        // Command2: Send each run of dirty digits in its own transaction.
+        uint8_t chipPos = 0;
+        while (chipPos < numDigits) {
+          if (! (dirtyChipBits & (1 << chipPos))) {
+            chipPos++;
+            continue;
+          }
+
+          mTmiInterface.startCondition();
+          mTmiInterface.write(kAddressCmd | chipPos);
+          while (chipPos < numDigits && (dirtyChipBits & (1 << chipPos))) {
+            uint8_t physicalPos = remapLogicalToPhysical(chipPos);
+            mTmiInterface.write(getStyledPatternAt(physicalPos));
+            clearDigitDirty(physicalPos);
+            chipPos++;
+          }
+          mTmiInterface.stopCondition();
+        }
+      }
+
+      // Command3: Update the brightness last, if needed.
+      if (isBrightnessDirty()) {
+        mTmiInterface.startCondition();
+        mTmiInterface.write(kBrightnessCmd
+            | (mDisplayOn ? kBrightnessLevelOn : 0x0)
+            | (getBrightness() & 0xF));
+        mTmiInterface.stopCondition();
+        clearBrightnessDirty();
+      }
     }
 
     /**
      * Update only a single digit or the brightness. This method must be called
-     * (T_DIGITS + 1) times to update the digits of entire module, including the
-     * brightness which is updated using a separate step. Uses the mFlushStage
-     * and the mIsDirty bit array to update only the part that needs updating.
+     * up to (getNumDigits() + 1) times to update the digits of entire module,
+     * including the brightness which is updated using a separate step. Uses
+     * the mFlushStage and the dirty bits to update only the part that needs
+     * updating. Clean digits are skipped over: each call jumps directly to the
+     * next dirty digit (or the brightness stage), and returns immediately if
+     * nothing is dirty.
      *
      * This method should be used if the processor cannot be blocked for the
      * entire duration of the flush() method (e.g. on the ESP8266, which will
@@ -191,7 +301,7 @@ class Tm1637Module : public LedModule {
      * 'min/avg/max:4/494/13780', so a maximum of 14 ms, which is still a little
      * bit high.
      *
-     * 2) If brightness is updated during its own mFlushStage (== T_DIGITS),
+     * 2) If brightness is updated during its own mFlushStage (== numDigits),
      * then I see `min/avg/max:4/492/10152`, saving about 3.5ms from the
      * latency. The side effect is a slightly flicker when the display and
      * brightness changes at the same time, because this incrementally updating
@@ -209,16 +319,20 @@ class Tm1637Module : public LedModule {
      * separate iterations.
      */
     void flushIncremental() {
-      if (mFlushStage == T_DIGITS) {
+      if (getStyler()) updateStyler(T_CI::millis());
+      const uint16_t dirtyStages = getDirtyStageBits();
+      if (dirtyStages == 0) return;
+
+      const uint8_t numDigits = getNumDigits();
+      mFlushStage = findNextDirtyStage(dirtyStages);
+      if (mFlushStage == numDigits) {
         // Update brightness.
-        if (isBrightnessDirty()) {
-          mTmiInterface.startCondition();
-          mTmiInterface.write(kBrightnessCmd
-              | (mDisplayOn ? kBrightnessLevelOn : 0x0)
-              | (getBrightness() & 0xF));
-          mTmiInterface.stopCondition();
-          clearBrightnessDirty();
-        }
+        mTmiInterface.startCondition();
+        mTmiInterface.write(kBrightnessCmd
+            | (mDisplayOn ? kBrightnessLevelOn : 0x0)
+            | (getBrightness() & 0xF));
+        mTmiInterface.stopCondition();
+        clearBrightnessDirty();
       } else {
         // Remap the logical position used by the controller to the actual
         // position. For example, if the controller digit 0 appears at physical
@@ -226,22 +340,125 @@ class Tm1637Module : public LedModule {
         // position 2 when sending the byte to controller digit 0.
         const uint8_t chipPos = mFlushStage;
         const uint8_t physicalPos = remapLogicalToPhysical(chipPos);
-        if (isDigitDirty(physicalPos)) {
-          // Update changed digit.
-          mTmiInterface.startCondition();
-          mTmiInterface.write(kDataCmdFixedAddress);
-          mTmiInterface.stopCondition();
 
-          mTmiInterface.startCondition();
-          mTmiInterface.write(kAddressCmd | chipPos);
-          mTmiInterface.write(mPatterns[physicalPos]);
-          mTmiInterface.stopCondition();
-          clearDigitDirty(physicalPos);
+        // Update changed digit.
+        mTmiInterface.startCondition();
+        mTmiInterface.write(kDataCmdFixedAddress);
+        mTmiInterface.stopCondition();
+
+        mTmiInterface.startCondition();
+        mTmiInterface.write(kAddressCmd | chipPos);
+        mTmiInterface.write(getStyledPatternAt(physicalPos));
+        mTmiInterface.stopCondition();
+        clearDigitDirty(physicalPos);
+      }
+
+      // An extra dirty bit is used for the brightness so use `numDigits + 1`.
+      ace_common::incrementMod(mFlushStage, (uint8_t) (numDigits + 1));
+    }
+
+    /**
+     * Call flushIncremental() repeatedly, processing as many dirty stages as
+     * will fit within `budgetMicros`. The longest stage seen so far in this
+     * call is used as the estimate of the next one, so the loop stops early
+     * instead of overrunning the budget. At least one stage is always
+     * processed if flushing is required, so that a small budget still makes
+     * progress.
+     *
+     * Clean digits are skipped by flushIncremental(), so every stage
+     * processed here sends something. A budget of 0 is the same as calling
+     * flushIncremental() once. A budget larger than the full flush time sends
+     * everything in one call, using the fixed addressing mode for each dirty
+     * digit.
+     *
+     * @param budgetMicros maximum number of micros to spend in this call
+     * @return true if more work remains, i.e. isFlushRequired() is still true
+     */
+    bool flushFor(uint16_t budgetMicros) {
+      uint16_t startMicros = T_CI::micros();
+      uint16_t maxStageMicros = 0;
+      while (isFlushRequired()) {
+        uint16_t stageStartMicros = T_CI::micros();
+        flushIncremental();
+        uint16_t now = T_CI::micros();
+        uint16_t stageMicros = now - stageStartMicros;
+        if (stageMicros > maxStageMicros) maxStageMicros = stageMicros;
+
+        // Stop if the next stage would exceed the budget.
+        uint16_t elapsedMicros = now - startMicros;
+        if (elapsedMicros >= budgetMicros
+            || maxStageMicros > (uint16_t) (budgetMicros - elapsedMicros)) {
+          break;
         }
       }
+      return isFlushRequired();
+    }
+
+    /**
+     * Start a resumable flush of all digits and the brightness, which is
+     * performed by calling step() until it returns false. The same data as
+     * flush() is sent, but in pieces of a bounded size, so that a cooperative
+     * scheduler can run other tasks in between. The dirty bits are cleared
+     * here, so a digit which is changed during the flush is flushed again
+     * later. Calling this while a flush is in progress restarts it.
+     */
+    void startFlush() {
+      if (getStyler()) updateStyler(T_CI::millis());
+      clearDigitsDirty();
+      clearBrightnessDirty();
+      mStepPos = kStepDataCmd;
+    }
+
+    /**
+     * Perform the next part of the flush started by startFlush(), sending at
+     * most `budgetBytes` bytes, not counting the start and stop conditions.
+     * The data command and the brightness take 1 byte each, and a run of
+     * digits takes 1 byte for the address command plus 1 byte per digit. At
+     * least one transaction is always sent, even if it exceeds the budget, so
+     * that every call makes progress.
+     *
+     * @return true if more steps are required, false if the flush is done or
+     *    was never started
+     */
+    bool step(uint8_t budgetBytes) {
+      const uint8_t numDigits = getNumDigits();
+      const uint8_t stepBrightness = numDigits + 1;
+      uint8_t numBytes = 0;
+
+      if (mStepPos == kStepDataCmd) {
+        mTmiInterface.startCondition();
+        mTmiInterface.write(kDataCmdAutoAddress);
+        mTmiInterface.stopCondition();
+        numBytes++;
+        mStepPos++;
+      }
+
+      // Positions [1, numDigits] are the chip positions plus 1.
+      if (mStepPos < stepBrightness
+          && (numBytes == 0 || numBytes + 2 <= budgetBytes)) {
+        mTmiInterface.startCondition();
+        mTmiInterface.write(kAddressCmd | (mStepPos - 1));
+        numBytes++;
+        do {
+          uint8_t physicalPos = remapLogicalToPhysical(mStepPos - 1);
+          mTmiInterface.write(getStyledPatternAt(physicalPos));
+          numBytes++;
+          mStepPos++;
+        } while (mStepPos < stepBrightness && numBytes < budgetBytes);
+        mTmiInterface.stopCondition();
+      }
 
-      // An extra dirty bit is used for the brightness so use `T_DIGITS + 1`.
-      ace_common::incrementMod(mFlushStage, (uint8_t) (T_DIGITS + 1));
+      if (mStepPos == stepBrightness
+          && (numBytes == 0 || numBytes + 1 <= budgetBytes)) {
+        mTmiInterface.startCondition();
+        mTmiInterface.write(kBrightnessCmd
+            | (mDisplayOn ? kBrightnessLevelOn : 0x0)
+            | (getBrightness() & 0xF));
+        mTmiInterface.stopCondition();
+        mStepPos = kStepDone;
+      }
+
+      return mStepPos != kStepDone;
     }
 
     //-----------------------------------------------------------------------
@@ -270,16 +487,130 @@ class Tm1637Module : public LedModule {
       return data;
     }
 
+    /**
+     * Read the buttons using readButtons() and convert the result into a bit
+     * mask, with a 1 bit for a pressed button. The buttons on the K1 line
+     * become bits 0-7 (SG1 to SG8), and the buttons on the K2 line become bits
+     * 8-15. The TM1637 reports only a single button at a time, so at most one
+     * bit will be set. This is the format expected by the ButtonScanner class.
+     */
+    uint32_t readButtonBits() const {
+      uint8_t data = ~readButtons();
+      uint8_t kn = (data & 0b00011000) >> 3;
+      uint8_t sn = data & 0b00000111;
+      if (kn == 0x1) return (uint32_t) 1 << sn;
+      if (kn == 0x2) return (uint32_t) 1 << (sn + 8);
+      return 0;
+    }
+
   private:
     /** Convert a logical position into the physical position. */
     uint8_t remapLogicalToPhysical(uint8_t pos) const {
-      return mRemapArray ? mRemapArray[pos] : pos;
+      return T_REMAP::remap(pos);
+    }
+
+    /**
+     * Return the dirty flags indexed by flush stage: bit N for chip position N
+     * (after remapping), and bit numDigits for the brightness.
+     */
+    uint16_t getDirtyStageBits() const {
+      const uint8_t numDigits = getNumDigits();
+      const uint8_t digitMask = (uint8_t) ((1U << numDigits) - 1);
+      uint16_t bits;
+      if (T_REMAP::isRemapped()) {
+        bits = 0;
+        for (uint8_t chipPos = 0; chipPos < numDigits; ++chipPos) {
+          if (isDigitDirty(T_REMAP::remap(chipPos))) bits |= (1U << chipPos);
+        }
+      } else {
+        bits = getDigitDirtyBits() & digitMask;
+      }
+      if (isBrightnessDirty()) bits |= (1U << numDigits);
+      return bits;
+    }
+
+    /**
+     * Send the segment patterns of all digits plus the brightness, without
+     * evaluating the Styler, which was done by the caller.
+     */
+    void writeAll() {
+      const uint8_t numDigits = getNumDigits();
+
+      // Command1: Update the digits using auto incrementing mode.
+      mTmiInterface.startCondition();
+      mTmiInterface.write(kDataCmdAutoAddress);
+      mTmiInterface.stopCondition();
+
+      // Command2: Send the LED patterns.
+      mTmiInterface.startCondition();
+      mTmiInterface.write(kAddressCmd);
+      for (uint8_t chipPos = 0; chipPos < numDigits; ++chipPos) {
+        // Remap the logical position used by the controller to the actual
+        // position. For example, if the controller digit 0 appears at physical
+        // digit 2, we need to display the segment pattern given by logical
+        // position 2 when sending the byte to controller digit 0.
+        uint8_t physicalPos = remapLogicalToPhysical(chipPos);
+        uint8_t effectivePattern = getStyledPatternAt(physicalPos);
+        mTmiInterface.write(effectivePattern);
+      }
+      mTmiInterface.stopCondition();
+
+      // Command3: Update the brightness last. This matches the recommendation
+      // given in the Titan Micro TM1637 datasheet. But experimentation shows
+      // that things seems to work even if brightness is sent first, before the
+      // digit patterns.
+      mTmiInterface.startCondition();
+      mTmiInterface.write(kBrightnessCmd
+          | (mDisplayOn ? kBrightnessLevelOn : 0x0)
+          | (getBrightness() & 0xF));
+      mTmiInterface.stopCondition();
+
+      clearDigitsDirty();
+      clearBrightnessDirty();
+    }
+
+    /**
+     * Cost of sending the digits using flush(): the data command, and the
+     * address command followed by every digit, in 2 transactions.
+     */
+    uint16_t fullFlushCost() const {
+      return 2 * kCostTransaction + (2 + getNumDigits()) * kCostByte;
+    }
+
+    /**
+     * Cost of sending `numDirty` digits in `numRuns` auto incrementing runs:
+     * the data command, then an address command and the digits for each run,
+     * with one transaction for each.
+     */
+    static uint16_t burstCost(uint8_t numRuns, uint8_t numDirty) {
+      return (1 + numRuns) * (kCostTransaction + kCostByte)
+          + numDirty * kCostByte;
+    }
+
+    /**
+     * Return the first dirty stage at or after mFlushStage, wrapping around
+     * after the brightness stage. The `dirtyStages` must be non-zero.
+     */
+    uint8_t findNextDirtyStage(uint16_t dirtyStages) const {
+      // Rotate the (numDigits + 1) stage bits so that mFlushStage is at bit 0.
+      // Bits shifted above the brightness stage are never the lowest set bit,
+      // so they can be ignored.
+      const uint8_t numStages = getNumDigits() + 1;
+      unsigned int rotated = ((unsigned int) dirtyStages >> mFlushStage)
+          | ((unsigned int) dirtyStages << (numStages - mFlushStage));
+      uint8_t stage = mFlushStage + __builtin_ctz(rotated);
+      return (stage >= numStages) ? stage - numStages : stage;
     }
 
   private:
     // Give access to mIsDirty and mFlushStage
     friend class ::Tm1637ModuleTest_flushIncremental;
+    friend class ::Tm1637ModuleTest_flushIncremental_wrapsAround;
     friend class ::Tm1637ModuleTest_flush;
+    friend class ::Tm1637ModuleTest_flushFor;
+    friend class ::Tm1637ModuleTest_flushBurst;
+    friend class ::Tm1637ModuleTest_flushBurst_remap;
+    friend class ::Tm1637ModuleTest_flushBurst_brightness;
 
     // These come from the TM1637 controller chip datasheet.
     static uint8_t const kDataCmdWriteDisplay = 0b01000000;
@@ -290,6 +621,16 @@ class Tm1637Module : public LedModule {
     static uint8_t const kBrightnessCmd =       0b10000000;
     static uint8_t const kBrightnessLevelOn =   0b00001000;
 
+    // Costs of the wire protocol, used by flushBurst().
+    static uint16_t const kCostByte = Tm1637CostTraits<T_TMII>::kCostByte;
+    static uint16_t const kCostTransaction =
+        Tm1637CostTraits<T_TMII>::kCostTransaction;
+
+    // Positions of the resumable flush, between the data command and the
+    // brightness at (numDigits + 1).
+    static uint8_t const kStepDataCmd = 0;
+    static uint8_t const kStepDone = 0xFF;
+
     // The ordering of these fields is partially determined to save memory on
     // 32-bit processors.
 
@@ -297,10 +638,59 @@ class Tm1637Module : public LedModule {
     // extra level of indirection.
     const T_TMII mTmiInterface;
 
-    const uint8_t* const mRemapArray;
-    uint8_t mPatterns[T_DIGITS];
     bool mDisplayOn;
-    uint8_t mFlushStage; // [0, T_DIGITS], with T_DIGITS for brightness update
+    uint8_t mFlushStage; // [0, numDigits], with numDigits for brightness update
+    uint8_t mStepPos; // position of the resumable flush, or kStepDone
+};
+
+/**
+ * An implementation of LedModule using the TM1637 chip. The chip communicates
+ * using a protocol that is electrically similar to I2C, but does not use an
+ * address byte at the beginning of the protocol.
+ *
+ * This class only provides the storage of the segment patterns. The logic is
+ * in Tm1637ModuleBase, which is shared by all modules using the same
+ * T_TMII, T_CI and T_REMAP, regardless of T_DIGITS.
+ *
+ * @tparam T_TMII class that implements the two wire protocol interface for
+ *    TM1637, usually one of the classes from the AceTMI library:
+ *    SimpleTmi1637Interface or SimpleTmi1637FastInterface.
+ * @tparam T_DIGITS number of digits in the LED module (usually 4 or 6)
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()), used by flushFor(). The default is ClockInterface.
+ * @tparam T_REMAP class that remaps the logical digit positions to their
+ *    physical positions: RemapArray (default) which uses the remapArray given
+ *    to the constructor, or a RemapSequence fixed at compile-time which uses
+ *    no RAM.
+ */
+template <
+    typename T_TMII,
+    uint8_t T_DIGITS,
+    typename T_CI = ClockInterface,
+    typename T_REMAP = RemapArray>
+class Tm1637Module : public Tm1637ModuleBase<T_TMII, T_CI, T_REMAP> {
+  public:
+    static_assert(! T_REMAP::kIsCompileTime
+        || T_REMAP::kNumPositions == T_DIGITS,
+        "T_REMAP must have T_DIGITS positions");
+
+    /**
+     * Constructor.
+     * @param tmiInterface instance of TM1637 interface class
+     * @param remapArray (optional, nullable) a mapping of the logical digit
+     *    positions to their physical positions, useful for 6-digt LED modules
+     *    whose digits are wired out of order
+     */
+    explicit Tm1637Module(
+        const T_TMII& tmiInterface,
+        typename T_REMAP::Argument remapArray = nullptr
+    ) :
+        Tm1637ModuleBase<T_TMII, T_CI, T_REMAP>(
+            tmiInterface, mPatterns, T_DIGITS, remapArray)
+    {}
+
+  private:
+    uint8_t mPatterns[T_DIGITS];
 };
 
 } // ace_segment
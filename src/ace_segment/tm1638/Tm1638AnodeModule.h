@@ -28,6 +28,7 @@ SOFTWARE.
 #include <stdint.h>
 #include <string.h> // memset()
 #include <Arduino.h> // delayMicroseconds()
+#include "../hw/ClockInterface.h"
 #include "../LedModule.h"
 
 class Tm1638ModuleTest_flushIncremental;
@@ -43,8 +44,13 @@ namespace ace_segment {
  *    interface for TM1638, usually one of the classes from the AceTMI library:
  *    SimpleTmi1638Interface or SimpleTmi1638FastInterface.
  * @tparam T_DIGITS number of digits in the LED module (usually 8)
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()), used to evaluate the Styler.
  */
-template <typename T_TMII, uint8_t T_DIGITS>
+template <
+    typename T_TMII,
+    uint8_t T_DIGITS,
+    typename T_CI = ClockInterface>
 class Tm1638AnodeModule : public LedModule {
   public:
 
@@ -121,6 +127,8 @@ class Tm1638AnodeModule : public LedModule {
      * to flush(), but often it is not necessary.
      */
     void flush() {
+      if (getStyler()) updateStyler(T_CI::millis());
+
       // Command1: Update the digits using auto incrementing mode.
       mTmiInterface.beginTransaction();
       mTmiInterface.write(kDataCmdAutoAddress);
@@ -140,7 +148,7 @@ class Tm1638AnodeModule : public LedModule {
         uint8_t gridPattern = 0x0;
         uint8_t gridMask = 0x80;
         for (uint8_t digit = 0; digit < T_DIGITS; ++digit) {
-          uint8_t digitPattern = mPatterns[digit];
+          uint8_t digitPattern = getStyledPatternAt(digit);
           if (digitPattern & digitMask) {
             gridPattern |= gridMask;
           }
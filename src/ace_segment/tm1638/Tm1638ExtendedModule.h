@@ -0,0 +1,168 @@
+/*
+MIT License
+
+Copyright (c) 2026 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_SEGMENT_TM1638_EXTENDED_MODULE_H
+#define ACE_SEGMENT_TM1638_EXTENDED_MODULE_H
+
+#include <stdint.h>
+#include <string.h> // memset()
+#include "../hw/ClockInterface.h"
+#include "../hw/remap.h"
+#include "Tm1638Module.h"
+
+namespace ace_segment {
+
+/**
+ * A variant of Tm1638Module which also drives the SEG9 and SEG10 lines of the
+ * TM1638 chip, for example the 8 discrete LEDs of the "LED&KEY" boards which
+ * are wired to SEG9 of each grid. Each position holds a 16-bit pattern: the
+ * low byte holds SEG1-SEG8 (the usual 7 segments plus decimal point), and bits
+ * 8 and 9 hold SEG9 and SEG10. The low bytes are stored in the usual
+ * LedModule patterns, so all of the writer classes continue to work.
+ *
+ * Each digit occupies 2 bytes in the display RAM of the TM1638: the even byte
+ * for SEG1-SEG8, and the odd byte for SEG9-SEG10. The flush() method sends
+ * both bytes of every digit, exactly like Tm1638Module::flush() which writes
+ * 0x00 into the odd bytes. Everything else (the display on/off, the buttons,
+ * the remapping, and the wire protocol) is inherited from Tm1638Module. The
+ * flushIncremental(), startFlush() and step() methods of Tm1638Module do not
+ * send the odd bytes, so the inheritance is protected, and only the supported
+ * methods are made public. A Tm1638ExtendedModule cannot be used as a
+ * Tm1638Module or a LedModule reference, but it provides the same methods
+ * used by the writer classes and by ButtonScanner.
+ *
+ * @tparam T_TMII class that implements the three wire SPI-like protocol
+ *    interface for TM1638, usually one of the classes from the AceTMI library:
+ *    SimpleTmi1638Interface or SimpleTmi1638FastInterface.
+ * @tparam T_DIGITS number of digits in the LED module (usually 8)
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()), used to evaluate the Styler.
+ * @tparam T_REMAP class that remaps the logical digit positions to their
+ *    physical positions: RemapArray (default) which uses the remapArray given
+ *    to the constructor, or a RemapSequence fixed at compile-time which uses
+ *    no RAM.
+ */
+template <
+    typename T_TMII,
+    uint8_t T_DIGITS,
+    typename T_CI = ClockInterface,
+    typename T_REMAP = RemapArray>
+class Tm1638ExtendedModule :
+    protected Tm1638Module<T_TMII, T_DIGITS, T_CI, T_REMAP> {
+  private:
+    using Base = Tm1638Module<T_TMII, T_DIGITS, T_CI, T_REMAP>;
+
+  public:
+    // The supported methods of LedModule and Tm1638Module.
+    using Base::getNumDigits;
+    using Base::size;
+    using Base::setPatternAt;
+    using Base::getPatternAt;
+    using Base::setBrightness;
+    using Base::getBrightness;
+    using Base::setDecimalPointAt;
+  #if ACE_SEGMENT_ENABLE_STYLER
+    using Base::setStyler;
+  #endif
+    using Base::getStyler;
+    using Base::updateStyler;
+    using Base::end;
+    using Base::setDisplayOn;
+    using Base::isFlushRequired;
+    using Base::getMicrosUntilNextFlush;
+    using Base::readButtons;
+    using Base::readButtonBits;
+
+    /**
+     * Constructor.
+     * @param tmiInterface instance of TM1638 interface class
+     * @param remapArray (optional, nullable) a mapping of the logical digit
+     *    positions to their physical positions, useful for 8-digt LED modules
+     *    whose digits are wired out of order
+     */
+    explicit Tm1638ExtendedModule(
+        const T_TMII& tmiInterface,
+        typename T_REMAP::Argument remapArray = nullptr
+    ) :
+        Base(tmiInterface, remapArray)
+    {}
+
+    //-----------------------------------------------------------------------
+    // Initialization and termination.
+    //-----------------------------------------------------------------------
+
+    /**
+     * Initialize the module. The SimpleTmi1638Interface or
+     * SimpleTmi1638FastInterface object must be initialized separately.
+     */
+    void begin() {
+      Base::begin();
+      memset(mExtraPatterns, 0, T_DIGITS);
+    }
+
+    //-----------------------------------------------------------------------
+    // Access to the 16-bit patterns.
+    //-----------------------------------------------------------------------
+
+    /**
+     * Set the 16-bit pattern at position pos. The low byte is the same as the
+     * pattern of setPatternAt(). Bit 8 is SEG9 and bit 9 is SEG10. The other
+     * bits are ignored.
+     */
+    void setPattern16At(uint8_t pos, uint16_t pattern) {
+      mExtraPatterns[pos] = (pattern >> 8) & kExtraPatternMask;
+      this->setPatternAt(pos, (uint8_t) pattern);
+    }
+
+    /** Get the 16-bit pattern at position pos. */
+    uint16_t getPattern16At(uint8_t pos) const {
+      return ((uint16_t) mExtraPatterns[pos] << 8) | this->getPatternAt(pos);
+    }
+
+    //-----------------------------------------------------------------------
+    // Methods related to rendering.
+    //-----------------------------------------------------------------------
+
+    /**
+     * Send the segment patterns of all digits, including SEG9 and SEG10, plus
+     * the brightness to the display (1+1+16+1 = 19 bytes for 8 digits).
+     */
+    void flush() {
+      if (this->getStyler()) this->updateStyler(T_CI::millis());
+      this->writeDigits(mExtraPatterns);
+      this->writeBrightness();
+      this->clearDigitsDirty();
+      this->clearBrightnessDirty();
+    }
+
+  private:
+    /** Valid bits of mExtraPatterns: SEG9 and SEG10. */
+    static uint8_t const kExtraPatternMask = 0b00000011;
+
+    uint8_t mExtraPatterns[T_DIGITS]; // SEG9-SEG10 in bits 0-1
+};
+
+} // ace_segment
+
+#endif
@@ -28,10 +28,15 @@ SOFTWARE.
 #include <stdint.h>
 #include <string.h> // memset()
 #include <Arduino.h> // delayMicroseconds()
+#include <AceCommon.h> // incrementMod()
+#include "../hw/ClockInterface.h"
+#include "../hw/remap.h"
 #include "../LedModule.h"
 
 class Tm1638ModuleTest_flushIncremental;
 class Tm1638ModuleTest_flush;
+class Tm1638ModuleTest_step;
+class Tm1638ExtendedModuleTest_flush;
 
 namespace ace_segment {
 
@@ -60,10 +65,23 @@ extern const uint8_t kDigitRemapArray8Tm1638[8];
  *    interface for TM1638, usually one of the classes from the AceTMI library:
  *    SimpleTmi1638Interface or SimpleTmi1638FastInterface.
  * @tparam T_DIGITS number of digits in the LED module (usually 8)
+ * @tparam T_CI class that provides access to Arduino clock functions (millis()
+ *    and micros()), used to evaluate the Styler.
+ * @tparam T_REMAP class that remaps the logical digit positions to their
+ *    physical positions: RemapArray (default) which uses the remapArray given
+ *    to the constructor, or a RemapSequence fixed at compile-time which uses
+ *    no RAM.
  */
-template <typename T_TMII, uint8_t T_DIGITS>
-class Tm1638Module : public LedModule {
+template <
+    typename T_TMII,
+    uint8_t T_DIGITS,
+    typename T_CI = ClockInterface,
+    typename T_REMAP = RemapArray>
+class Tm1638Module : public LedModule, private T_REMAP {
   public:
+    static_assert(! T_REMAP::kIsCompileTime
+        || T_REMAP::kNumPositions == T_DIGITS,
+        "T_REMAP must have T_DIGITS positions");
 
     /**
      * Constructor.
@@ -74,11 +92,11 @@ class Tm1638Module : public LedModule {
      */
     explicit Tm1638Module(
         const T_TMII& tmiInterface,
-        const uint8_t* remapArray = nullptr
+        typename T_REMAP::Argument remapArray = nullptr
     ) :
         LedModule(mPatterns, T_DIGITS),
-        mTmiInterface(tmiInterface),
-        mRemapArray(remapArray)
+        T_REMAP(remapArray),
+        mTmiInterface(tmiInterface)
     {}
 
     //-----------------------------------------------------------------------
@@ -94,6 +112,8 @@ class Tm1638Module : public LedModule {
 
       memset(mPatterns, 0, T_DIGITS);
       setDisplayOn(true);
+      mFlushStage = 0;
+      mStepPos = kStepDone;
     }
 
     /** Signal end of usage. Currently does nothing. */
@@ -123,6 +143,17 @@ class Tm1638Module : public LedModule {
       return isAnyDigitDirty() || isBrightnessDirty();
     }
 
+    /**
+     * Return the number of micros until flushIncremental() has work to do: 0
+     * if a stage is pending, otherwise kMicrosNoDeadline. A low-power loop()
+     * can combine this with the deadlines of its other tasks to decide how
+     * long to sleep. A Styler is evaluated only by the flush methods, so its
+     * effects require a periodic flush regardless of this deadline.
+     */
+    uint32_t getMicrosUntilNextFlush() const {
+      return isFlushRequired() ? 0 : kMicrosNoDeadline;
+    }
+
     /**
      * Send segment patterns of all digits plus the brightness to the display.
      *
@@ -140,38 +171,130 @@ class Tm1638Module : public LedModule {
      * to flush(), but often it is not necessary.
      */
     void flush() {
-      // Command1: Update the digits using auto incrementing mode.
-      mTmiInterface.beginTransaction();
-      mTmiInterface.write(kDataCmdAutoAddress);
-      mTmiInterface.endTransaction();
+      if (getStyler()) updateStyler(T_CI::millis());
 
-      // Command2: Send the LED patterns.
-      mTmiInterface.beginTransaction();
-      mTmiInterface.write(kAddressCmd);
-      for (uint8_t chipPos = 0; chipPos < T_DIGITS; ++chipPos) {
-        // Remap the logical position used by the controller to the actual
-        // position. For example, if the controller digit 0 appears at physical
-        // digit 2, we need to display the segment pattern given by logical
-        // position 2 when sending the byte to controller digit 0.
-        uint8_t physicalPos = remapLogicalToPhysical(chipPos);
-        uint8_t effectivePattern = mPatterns[physicalPos];
-        mTmiInterface.write(effectivePattern);
-        mTmiInterface.write(0x00); // SEG8 and SEG9 not supported in this class
+      // SEG9 and SEG10 are not supported in this class.
+      writeDigits(nullptr);
+
+      // Update the brightness last. This matches the recommendation given in
+      // the Titan Micro TM1638 datasheet. But experimentation shows that things
+      // seems to work even if brightness is sent first, before the digit
+      // patterns.
+      writeBrightness();
+
+      clearDigitsDirty();
+      clearBrightnessDirty();
+    }
+
+    /**
+     * Update only a single dirty digit or the brightness, using the fixed
+     * addressing mode of the TM1638. The mFlushStage advances through the
+     * digits, with the brightness at stage T_DIGITS, skipping over the stages
+     * which are not dirty. Returns immediately if nothing is dirty. Only the
+     * even byte (SEG1-SEG8) of each digit is written, since the SEG9 and SEG10
+     * lines are not supported by this class.
+     *
+     * The TM1638 is fast enough that flush() is usually good enough, but this
+     * allows the flushing to be interleaved with other work, such as the
+     * button scanning in ButtonScanner.
+     */
+    void flushIncremental() {
+      if (getStyler()) updateStyler(T_CI::millis());
+      // Find the next dirty stage, in the order of the chip positions.
+      const uint8_t numStages = T_DIGITS + 1;
+      uint8_t stage = mFlushStage;
+      bool found = false;
+      for (uint8_t i = 0; i < numStages; ++i) {
+        found = (stage == T_DIGITS)
+            ? isBrightnessDirty()
+            : isDigitDirty(remapLogicalToPhysical(stage));
+        if (found) break;
+        ace_common::incrementMod(stage, numStages);
+      }
+      if (! found) return;
+
+      if (stage == T_DIGITS) {
+        writeBrightness();
+        clearBrightnessDirty();
+      } else {
+        const uint8_t chipPos = stage;
+        const uint8_t physicalPos = remapLogicalToPhysical(chipPos);
+
+        mTmiInterface.beginTransaction();
+        mTmiInterface.write(kDataCmdFixedAddress);
+        mTmiInterface.endTransaction();
+
+        mTmiInterface.beginTransaction();
+        mTmiInterface.write(kAddressCmd | (chipPos * 2));
+        mTmiInterface.write(getStyledPatternAt(physicalPos));
+        mTmiInterface.endTransaction();
+        clearDigitDirty(physicalPos);
       }
-      mTmiInterface.endTransaction();
 
-      // Command3: Update the brightness last. This matches the recommendation
-      // given in the Titan Micro TM1638 datasheet. But experimentation shows
-      // that things seems to work even if brightness is sent first, before the
-      // digit patterns.
-      mTmiInterface.beginTransaction();
-      mTmiInterface.write(kBrightnessCmd
-          | (mDisplayOn ? kBrightnessLevelOn : 0x0)
-          | (getBrightness() & 0xF));
-      mTmiInterface.endTransaction();
+      ace_common::incrementMod(stage, numStages);
+      mFlushStage = stage;
+    }
 
+    /**
+     * Start a resumable flush of all digits and the brightness, which is
+     * performed by calling step() until it returns false. The same data as
+     * flush() is sent, but in pieces of a bounded size. The dirty bits are
+     * cleared here, so a digit which is changed during the flush is flushed
+     * again later. Calling this while a flush is in progress restarts it.
+     */
+    void startFlush() {
+      if (getStyler()) updateStyler(T_CI::millis());
       clearDigitsDirty();
       clearBrightnessDirty();
+      mStepPos = kStepDataCmd;
+    }
+
+    /**
+     * Perform the next part of the flush started by startFlush(), sending at
+     * most `budgetBytes` bytes, not counting the STB framing. The data command
+     * and the brightness take 1 byte each, and a run of digits takes 1 byte for
+     * the address command plus 2 bytes per digit. At least one transaction is
+     * always sent, even if it exceeds the budget, so that every call makes
+     * progress.
+     *
+     * @return true if more steps are required, false if the flush is done or
+     *    was never started
+     */
+    bool step(uint8_t budgetBytes) {
+      const uint8_t stepBrightness = T_DIGITS + 1;
+      uint8_t numBytes = 0;
+
+      if (mStepPos == kStepDataCmd) {
+        mTmiInterface.beginTransaction();
+        mTmiInterface.write(kDataCmdAutoAddress);
+        mTmiInterface.endTransaction();
+        numBytes++;
+        mStepPos++;
+      }
+
+      // Positions [1, T_DIGITS] are the chip positions plus 1.
+      if (mStepPos < stepBrightness
+          && (numBytes == 0 || numBytes + 3 <= budgetBytes)) {
+        mTmiInterface.beginTransaction();
+        mTmiInterface.write(kAddressCmd | ((mStepPos - 1) * 2));
+        numBytes++;
+        do {
+          uint8_t physicalPos = remapLogicalToPhysical(mStepPos - 1);
+          mTmiInterface.write(getStyledPatternAt(physicalPos));
+          mTmiInterface.write(0x00); // SEG8 and SEG9 not supported
+          numBytes += 2;
+          mStepPos++;
+        } while (mStepPos < stepBrightness && numBytes + 2 <= budgetBytes);
+        mTmiInterface.endTransaction();
+      }
+
+      if (mStepPos == stepBrightness
+          && (numBytes == 0 || numBytes + 1 <= budgetBytes)) {
+        writeBrightness();
+        mStepPos = kStepDone;
+      }
+
+      return mStepPos != kStepDone;
     }
 
     //-----------------------------------------------------------------------
@@ -207,15 +330,62 @@ class Tm1638Module : public LedModule {
       return data;
     }
 
-  private:
+    /**
+     * Same as readButtons(), which already returns a bit mask with a 1 bit
+     * for each pressed button. Provided for consistency with
+     * Tm1637Module::readButtonBits(), as expected by ButtonScanner.
+     */
+    uint32_t readButtonBits() const {
+      return readButtons();
+    }
+
+  protected:
     /** Convert a logical position into the physical position. */
     uint8_t remapLogicalToPhysical(uint8_t pos) const {
-      return mRemapArray ? mRemapArray[pos] : pos;
+      return T_REMAP::remap(pos);
+    }
+
+    /**
+     * Send both bytes of every digit using the auto incrementing mode. The odd
+     * byte holds SEG9 and SEG10, which is taken from `extraPatterns` indexed
+     * by the physical position, or is 0x00 if `extraPatterns` is null.
+     */
+    void writeDigits(const uint8_t* extraPatterns) {
+      // Command1: Update the digits using auto incrementing mode.
+      mTmiInterface.beginTransaction();
+      mTmiInterface.write(kDataCmdAutoAddress);
+      mTmiInterface.endTransaction();
+
+      // Command2: Send the LED patterns.
+      mTmiInterface.beginTransaction();
+      mTmiInterface.write(kAddressCmd);
+      for (uint8_t chipPos = 0; chipPos < T_DIGITS; ++chipPos) {
+        // Remap the logical position used by the controller to the actual
+        // position. For example, if the controller digit 0 appears at physical
+        // digit 2, we need to display the segment pattern given by logical
+        // position 2 when sending the byte to controller digit 0.
+        uint8_t physicalPos = remapLogicalToPhysical(chipPos);
+        mTmiInterface.write(getStyledPatternAt(physicalPos));
+        mTmiInterface.write(extraPatterns ? extraPatterns[physicalPos] : 0x00);
+      }
+      mTmiInterface.endTransaction();
+    }
+
+    /** Send the brightness and the display on/off bit. */
+    void writeBrightness() {
+      mTmiInterface.beginTransaction();
+      mTmiInterface.write(kBrightnessCmd
+          | (mDisplayOn ? kBrightnessLevelOn : 0x0)
+          | (getBrightness() & 0xF));
+      mTmiInterface.endTransaction();
     }
 
   private:
-    // Give access to mIsDirty.
+    // Give access to mIsDirty and mFlushStage.
     friend class ::Tm1638ModuleTest_flush;
+    friend class ::Tm1638ModuleTest_flushIncremental;
+    friend class ::Tm1638ModuleTest_step;
+    friend class ::Tm1638ExtendedModuleTest_flush;
 
     // These come from the TM1638 controller chip datasheet.
     static uint8_t const kDataCmdWriteDisplay = 0b01000000;
@@ -226,6 +396,11 @@ class Tm1638Module : public LedModule {
     static uint8_t const kBrightnessCmd =       0b10000000;
     static uint8_t const kBrightnessLevelOn =   0b00001000;
 
+    // Positions of the resumable flush, between the data command and the
+    // brightness at (T_DIGITS + 1).
+    static uint8_t const kStepDataCmd = 0;
+    static uint8_t const kStepDone = 0xFF;
+
     // The ordering of these fields is partially determined to save memory on
     // 32-bit processors.
 
@@ -233,9 +408,10 @@ class Tm1638Module : public LedModule {
     // extra level of indirection.
     const T_TMII mTmiInterface;
 
-    const uint8_t* const mRemapArray;
     uint8_t mPatterns[T_DIGITS];
     bool mDisplayOn;
+    uint8_t mFlushStage; // [0, T_DIGITS], with T_DIGITS for brightness update
+    uint8_t mStepPos; // position of the resumable flush, or kStepDone
 };
 
 } // ace_segment
@@ -0,0 +1,226 @@
+#line 2 "ButtonDebouncerTest.ino"
+
+/*
+ * MIT License
+ * Copyright (c) 2026 Brian T. Park
+ */
+
+#include <stdarg.h>
+#include <Arduino.h>
+#include <AUnitVerbose.h>
+#include <AceSegment.h>
+#include <ace_segment/testing/EventLog.h>
+#include <ace_segment/testing/TestableClockInterface.h>
+#include <ace_segment/testing/TestableGpioInterface.h>
+#include <ace_segment/testing/TestableTmi1637Interface.h>
+
+using aunit::TestRunner;
+using namespace ace_segment;
+using namespace ace_segment::testing;
+
+//----------------------------------------------------------------------------
+// ButtonDebouncer
+//----------------------------------------------------------------------------
+
+const uint16_t LONG_PRESS_MILLIS = 1000;
+
+ButtonDebouncer<4> debouncer(LONG_PRESS_MILLIS);
+
+test(ButtonDebouncerTest, debounce) {
+  ButtonEvent event;
+  debouncer.begin(0);
+  assertEqual((uint32_t) 0, debouncer.getButtons());
+
+  // Button 3 and 17 must be stable for 4 samples before being pressed.
+  const uint32_t buttons = ((uint32_t) 1 << 3) | ((uint32_t) 1 << 17);
+  debouncer.update(buttons, 5);
+  debouncer.update(buttons, 10);
+  debouncer.update(buttons, 15);
+  assertEqual((uint32_t) 0, debouncer.getButtons());
+  assertFalse(debouncer.isEventAvailable());
+  debouncer.update(buttons, 20);
+  assertEqual(buttons, debouncer.getButtons());
+
+  assertTrue(debouncer.readEvent(event));
+  assertEqual(kButtonEventPressed, event.type);
+  assertEqual(3, event.button);
+  assertTrue(debouncer.readEvent(event));
+  assertEqual(kButtonEventPressed, event.type);
+  assertEqual(17, event.button);
+  assertFalse(debouncer.readEvent(event));
+
+  // A bounce on button 3 resets its counter, so it stays pressed.
+  debouncer.update(buttons & ~0x8, 25);
+  debouncer.update(buttons & ~0x8, 30);
+  debouncer.update(buttons, 35);
+  debouncer.update(buttons & ~0x8, 40);
+  debouncer.update(buttons & ~0x8, 45);
+  debouncer.update(buttons & ~0x8, 50);
+  assertEqual(buttons, debouncer.getButtons());
+  assertFalse(debouncer.isEventAvailable());
+
+  // Fourth consecutive sample releases button 3.
+  debouncer.update(buttons & ~0x8, 55);
+  assertEqual((uint32_t) 1 << 17, debouncer.getButtons());
+  assertTrue(debouncer.readEvent(event));
+  assertEqual(kButtonEventReleased, event.type);
+  assertEqual(3, event.button);
+
+  // Button 17 generates a long press exactly once.
+  debouncer.update((uint32_t) 1 << 17, 55 + LONG_PRESS_MILLIS - 1);
+  assertFalse(debouncer.isEventAvailable());
+  debouncer.update((uint32_t) 1 << 17, 55 + LONG_PRESS_MILLIS);
+  assertTrue(debouncer.readEvent(event));
+  assertEqual(kButtonEventLongPressed, event.type);
+  assertEqual(17, event.button);
+  debouncer.update((uint32_t) 1 << 17, 55 + 2 * LONG_PRESS_MILLIS);
+  assertFalse(debouncer.isEventAvailable());
+}
+
+test(ButtonDebouncerTest, queueOverflow) {
+  ButtonEvent event;
+  debouncer.begin(0);
+
+  // 6 buttons pressed at once, but only 4 events fit in the queue.
+  for (uint8_t i = 0; i < 4; ++i) {
+    debouncer.update(0x3F, i);
+  }
+  assertEqual((uint32_t) 0x3F, debouncer.getButtons());
+  for (uint8_t i = 0; i < 4; ++i) {
+    assertTrue(debouncer.readEvent(event));
+    assertEqual(i, event.button);
+  }
+  assertFalse(debouncer.readEvent(event));
+}
+
+//----------------------------------------------------------------------------
+// ButtonScanner
+//----------------------------------------------------------------------------
+
+const uint8_t NUM_DIGITS = 4;
+const uint8_t SCAN_INTERVAL_MILLIS = 5;
+TestableTmi1637Interface tmiInterface;
+using TmModule = Tm1637Module<TestableTmi1637Interface, NUM_DIGITS>;
+TmModule tm1637Module(tmiInterface);
+ButtonScanner<TmModule, TestableClockInterface> buttonScanner(
+    tm1637Module, SCAN_INTERVAL_MILLIS, LONG_PRESS_MILLIS);
+
+test(ButtonScannerTest, update) {
+  ButtonEvent event;
+  TestableTmi1637Interface::sReadData = 0xFF;
+  TestableClockInterface::setMillis(0);
+  tm1637Module.begin();
+  buttonScanner.begin();
+
+  // Between scans, update() performs one incremental flush stage at a time.
+  gEventLog.clear();
+  assertFalse(buttonScanner.update());
+  assertEqual(7, gEventLog.getNumRecords());
+  for (uint8_t i = 0; i < NUM_DIGITS; ++i) {
+    assertFalse(buttonScanner.update());
+  }
+  assertFalse(tm1637Module.isFlushRequired());
+
+  // Nothing dirty, so nothing is sent.
+  gEventLog.clear();
+  assertFalse(buttonScanner.update());
+  assertEqual(0, gEventLog.getNumRecords());
+
+  // Button on K2 and SG3 (0b10010 inverted) becomes button 8 + 2.
+  TestableTmi1637Interface::sReadData = ~0b10010;
+  for (uint8_t i = 1; i <= 4; ++i) {
+    TestableClockInterface::setMillis(i * SCAN_INTERVAL_MILLIS);
+    gEventLog.clear();
+    assertTrue(buttonScanner.update());
+    assertTrue(gEventLog.assertEvents(
+      4,
+      (int) EventType::kTmi1637StartCondition,
+      (int) EventType::kTmi1637SendByte, 0b01000010, // kDataCmdReadKeys
+      (int) EventType::kTmi1637ReadByte, (uint8_t) ~0b10010,
+      (int) EventType::kTmi1637StopCondition
+    ));
+
+    // Another call before the next interval does not read the keys again.
+    assertFalse(buttonScanner.update());
+  }
+  assertEqual((uint32_t) 1 << 10, buttonScanner.getButtons());
+  assertTrue(buttonScanner.readEvent(event));
+  assertEqual(kButtonEventPressed, event.type);
+  assertEqual(10, event.button);
+
+  TestableTmi1637Interface::sReadData = 0xFF;
+}
+
+//----------------------------------------------------------------------------
+// ButtonScanner with a key matrix sharing the digit pins of a ScanningModule
+//----------------------------------------------------------------------------
+
+const uint8_t SEGMENT_PINS[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+const uint8_t DIGIT_PINS[2] = {8, 9};
+const uint8_t KEY_PIN = 10;
+
+// Common Cathode, so the digit pins are active LOW, and a pressed key pulls
+// the key-return pin LOW while its digit is enabled.
+using LedMatrix = LedMatrixDirect<TestableGpioInterface, true /*T_KEYS*/>;
+LedMatrix ledMatrix(
+    kActiveHighPattern /*elementOnPattern*/,
+    kActiveLowPattern /*groupOnPattern*/,
+    8 /*numElements*/,
+    SEGMENT_PINS,
+    2 /*numGroups*/,
+    DIGIT_PINS,
+    KEY_PIN);
+using KeyModule = ScanningModule<LedMatrix, 2, 1, TestableClockInterface>;
+KeyModule keyModule(ledMatrix, 60);
+ButtonScanner<KeyModule, TestableClockInterface, 8, RenderFieldPolicy>
+  keyScanner(keyModule, SCAN_INTERVAL_MILLIS, LONG_PRESS_MILLIS);
+
+test(ButtonScannerTest, scanningModule) {
+  ButtonEvent event;
+  TestableClockInterface::setMillis(0);
+  ledMatrix.begin();
+  keyModule.begin();
+  keyScanner.begin();
+
+  // Press the key of digit 1. Each frame samples digit 1 while drawing digit
+  // 0, and digit 0 while drawing digit 1. The first frame has nothing to
+  // sample for digit 1, so 5 frames are needed for 4 stable scans.
+  for (uint8_t i = 1; i <= 5; i++) {
+    TestableGpioInterface::sReadValue = LOW;
+    keyModule.renderFieldNow();
+    TestableGpioInterface::sReadValue = HIGH;
+    keyModule.renderFieldNow();
+    TestableClockInterface::setMillis(i * SCAN_INTERVAL_MILLIS);
+    assertTrue(keyScanner.update());
+  }
+  assertEqual((uint32_t) 0x2, keyModule.readButtonBits());
+  assertEqual((uint32_t) 0x2, keyScanner.getButtons());
+  assertTrue(keyScanner.readEvent(event));
+  assertEqual(kButtonEventPressed, event.type);
+  assertEqual(1, event.button);
+
+  // A field which is due is rendered on a scan tick too.
+  TestableClockInterface::setMicros(keyModule.getMicrosPerField());
+  TestableClockInterface::setMillis(6 * SCAN_INTERVAL_MILLIS);
+  gEventLog.clear();
+  assertTrue(keyScanner.update());
+  assertTrue(gEventLog.getNumRecords() > 0);
+
+  keyModule.end();
+  ledMatrix.end();
+}
+
+//----------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // Wait for stability on some boards, otherwise garage on Serial
+#endif
+
+  Serial.begin(115200); // ESP8266 default of 74880 not supported on Linux
+  while (!Serial); // Wait until Serial is ready - Leonardo/Micro
+}
+
+void loop() {
+  TestRunner::run();
+}
@@ -14,6 +14,8 @@
 
 using aunit::TestRunner;
 using ace_segment::testing::TestableWireInterface;
+using ace_segment::testing::EventType;
+using ace_segment::testing::gEventLog;
 using ace_segment::Ht16k33Module;
 
 //----------------------------------------------------------------------------
@@ -68,6 +70,96 @@ test(Ht16k33ModuleTest, isFlushRequired) {
   ht16k33Module.end();
 }
 
+test(Ht16k33ModuleTest, autoPowerDown) {
+  ht16k33Module.begin();
+  ht16k33Module.setAutoPowerDown(true);
+
+  // A blank display turns off the display and the oscillator.
+  gEventLog.clear();
+  ht16k33Module.flush();
+  assertTrue(ht16k33Module.isPoweredDown());
+  assertTrue(gEventLog.assertEvents(
+      6,
+      (int) EventType::kWireBeginTransmission, HT16K33_I2C_ADDRESS,
+      (int) EventType::kWireWrite, 0x80, // kDisplayOff
+      (int) EventType::kWireEndTransmission,
+      (int) EventType::kWireBeginTransmission, HT16K33_I2C_ADDRESS,
+      (int) EventType::kWireWrite, 0x20, // kSystemOff
+      (int) EventType::kWireEndTransmission));
+
+  gEventLog.clear();
+  ht16k33Module.flush();
+  assertEqual(0, gEventLog.getNumRecords());
+
+  // A non-blank digit wakes up the chip: kSystemOn, 5 digits, brightness,
+  // then kDisplayOn.
+  ht16k33Module.setPatternAt(0, 0x01);
+  gEventLog.clear();
+  ht16k33Module.flush();
+  assertFalse(ht16k33Module.isPoweredDown());
+  assertEqual(3 + 13 + 3 + 3, gEventLog.getNumRecords());
+
+  ht16k33Module.setAutoPowerDown(false);
+  ht16k33Module.end();
+}
+
+test(Ht16k33ModuleTest, step) {
+  ht16k33Module.begin();
+  ht16k33Module.setAutoPowerDown(true);
+  assertFalse(ht16k33Module.step(1));
+
+  // A blank display powers down using one command per step.
+  ht16k33Module.startFlush();
+  gEventLog.clear();
+  assertTrue(ht16k33Module.step(1));
+  assertTrue(gEventLog.assertEvents(
+      3,
+      (int) EventType::kWireBeginTransmission, HT16K33_I2C_ADDRESS,
+      (int) EventType::kWireWrite, 0x80, // kDisplayOff
+      (int) EventType::kWireEndTransmission));
+  assertFalse(ht16k33Module.step(1));
+  assertTrue(ht16k33Module.isPoweredDown());
+
+  // Waking up: kSystemOn alone, since the digits do not fit in the budget.
+  ht16k33Module.setPatternAt(0, 0x01);
+  ht16k33Module.startFlush();
+  assertFalse(ht16k33Module.isFlushRequired());
+  gEventLog.clear();
+  assertTrue(ht16k33Module.step(1));
+  assertTrue(gEventLog.assertEvents(
+      3,
+      (int) EventType::kWireBeginTransmission, HT16K33_I2C_ADDRESS,
+      (int) EventType::kWireWrite, 0x21, // kSystemOn
+      (int) EventType::kWireEndTransmission));
+
+  // The address and 2 physical digits fit in 5 bytes.
+  gEventLog.clear();
+  assertTrue(ht16k33Module.step(5));
+  assertTrue(gEventLog.assertEvents(
+      7,
+      (int) EventType::kWireBeginTransmission, HT16K33_I2C_ADDRESS,
+      (int) EventType::kWireWrite, 0x00, // address of COM0
+      (int) EventType::kWireWrite, 0x01,
+      (int) EventType::kWireWrite, 0x00,
+      (int) EventType::kWireWrite, 0x00,
+      (int) EventType::kWireWrite, 0x00,
+      (int) EventType::kWireEndTransmission));
+  // The step ends with a STOP, which releases the bus between the steps.
+  assertEqual(true, (bool) gEventLog.getEvent(6).arg1);
+
+  // The remaining 3 physical digits starting at COM2, the brightness, then
+  // kDisplayOn. The brightness follows the digits with a repeated START.
+  gEventLog.clear();
+  assertFalse(ht16k33Module.step(255));
+  assertEqual(9 + 3 + 3, gEventLog.getNumRecords());
+  assertEqual((int) EventType::kWireEndTransmission,
+      (int) gEventLog.getEvent(8).type);
+  assertEqual(false, (bool) gEventLog.getEvent(8).arg1);
+
+  ht16k33Module.setAutoPowerDown(false);
+  ht16k33Module.end();
+}
+
 //----------------------------------------------------------------------------
 
 void setup() {
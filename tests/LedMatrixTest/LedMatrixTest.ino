@@ -11,6 +11,7 @@
 #include <AceSegment.h>
 #include <ace_segment/testing/TestableClockInterface.h>
 #include <ace_segment/testing/TestableGpioInterface.h>
+#include <ace_segment/testing/TestablePwmInterface.h>
 #include <ace_segment/testing/TestableSpiInterface.h>
 
 using aunit::TestRunner;
@@ -42,6 +43,17 @@ LedMatrixSingleHc595<TestableSpiInterface, TestableGpioInterface>
     NUM_DIGITS,
     DIGIT_PINS);
 
+// Same as ledMatrixSingleHc595, with a key matrix on the Group pins.
+const uint8_t KEY_PIN = 13;
+LedMatrixSingleHc595<TestableSpiInterface, TestableGpioInterface, true>
+  ledMatrixSingleHc595Keys(
+    spiInterface,
+    kActiveHighPattern /*elementOnPattern*/,
+    kActiveHighPattern /*groupOnPattern*/,
+    NUM_DIGITS,
+    DIGIT_PINS,
+    KEY_PIN);
+
 // Common Cathode, with transistors on Group pins
 LedMatrixDualHc595<TestableSpiInterface> ledMatrixDualHc595(
     spiInterface,
@@ -49,6 +61,24 @@ LedMatrixDualHc595<TestableSpiInterface> ledMatrixDualHc595(
     kActiveHighPattern /*groupOnPattern*/,
     kByteOrderGroupHighElementLow);
 
+// 2 banks of 4 digits, Common Cathode, with transistors on Group pins
+LedMatrixDualBankHc595<TestableSpiInterface> ledMatrixDualBankHc595(
+    spiInterface,
+    kActiveHighPattern /*elementOnPattern*/,
+    kActiveHighPattern /*groupOnPattern*/,
+    4 /*groupsPerBank*/);
+
+// Same as ledMatrixDualHc595, with a PWM signal on the OE pin.
+const uint8_t OE_PIN = 12;
+LedMatrixDualHc595<TestableSpiInterface, TestablePwmInterface>
+  ledMatrixDualHc595Pwm(
+    spiInterface,
+    kActiveHighPattern /*elementOnPattern*/,
+    kActiveHighPattern /*groupOnPattern*/,
+    kByteOrderGroupHighElementLow,
+    nullptr /*remapArrayInverted*/,
+    OE_PIN);
+
 // ----------------------------------------------------------------------
 // Tests for LedMatrixSplitDirect.
 // ----------------------------------------------------------------------
@@ -201,6 +231,42 @@ testF(LedMatrixSingleHc595Test, drawElements) {
   ));
 }
 
+test(LedMatrixSingleHc595Test, sampleKey) {
+  // The group pins are active HIGH, so the key-return pin is an INPUT with an
+  // external pull-down.
+  gEventLog.clear();
+  ledMatrixSingleHc595Keys.begin();
+  assertEqual(2 * NUM_DIGITS + 1, gEventLog.getNumRecords());
+  assertEqual((int) EventType::kPinMode,
+      (int) gEventLog.getEvent(2 * NUM_DIGITS).type);
+  assertEqual(KEY_PIN, gEventLog.getEvent(2 * NUM_DIGITS).arg1);
+  assertEqual(INPUT, gEventLog.getEvent(2 * NUM_DIGITS).arg2);
+
+  // No group is enabled yet, so there is nothing to sample.
+  TestableGpioInterface::sReadValue = HIGH;
+  gEventLog.clear();
+  ledMatrixSingleHc595Keys.draw(2, 0x22);
+  assertEqual(3, gEventLog.getNumRecords());
+
+  // The key of group 2 is sampled before group 2 is disabled.
+  gEventLog.clear();
+  ledMatrixSingleHc595Keys.draw(3, 0x33);
+  assertTrue(gEventLog.assertEvents(4,
+      (int) EventType::kDigitalRead, KEY_PIN, HIGH,
+      (int) EventType::kDigitalWrite, 2, LOW,
+      (int) EventType::kSpiSend8, 0x33,
+      (int) EventType::kDigitalWrite, 3, HIGH));
+  assertEqual(0x4, ledMatrixSingleHc595Keys.getKeyBits());
+
+  // The key of group 3 is not pressed.
+  TestableGpioInterface::sReadValue = LOW;
+  ledMatrixSingleHc595Keys.draw(0, 0x00);
+  assertEqual(0x4, ledMatrixSingleHc595Keys.getKeyBits());
+
+  TestableGpioInterface::sReadValue = HIGH;
+  ledMatrixSingleHc595Keys.end();
+}
+
 // ----------------------------------------------------------------------
 // Tests for LedMatrixSplitSpi.
 // ----------------------------------------------------------------------
@@ -252,6 +318,193 @@ testF(LedMatrixDualHc595Test, draw) {
   ));
 }
 
+testF(LedMatrixDualHc595Test, setBrightness) {
+  // Without a PWM interface, brightness is ignored.
+  ledMatrixDualHc595.setBrightness(64);
+  assertEqual(0, gEventLog.getNumRecords());
+
+  // The OE pin is active-low, so the duty cycle is inverted.
+  ledMatrixDualHc595Pwm.setBrightness(64);
+  assertTrue(gEventLog.assertEvents(1,
+      (int) EventType::kAnalogWrite, OE_PIN, 255 - 64));
+
+  // end() disables the outputs.
+  gEventLog.clear();
+  ledMatrixDualHc595Pwm.end();
+  assertTrue(gEventLog.assertEvents(1,
+      (int) EventType::kAnalogWrite, OE_PIN, 255));
+}
+
+// ----------------------------------------------------------------------
+// Tests for LedMatrixDualBankHc595.
+// ----------------------------------------------------------------------
+
+test(LedMatrixDualBankHc595Test, drawBanks) {
+  gEventLog.clear();
+  ledMatrixDualBankHc595.drawBanks(1, 0x11, 0x55);
+
+  // Group 1 of both banks, then the bank B and bank A elements, in a single
+  // transaction.
+  assertTrue(gEventLog.assertEvents(5,
+      (int) EventType::kSpiBeginTransaction,
+      (int) EventType::kSpiTransfer, (0x1 << 1) | (0x1 << 5),
+      (int) EventType::kSpiTransfer, 0x55,
+      (int) EventType::kSpiTransfer, 0x11,
+      (int) EventType::kSpiEndTransaction));
+
+  // A single group of bank B.
+  gEventLog.clear();
+  ledMatrixDualBankHc595.draw(6, 0x66);
+  assertTrue(gEventLog.assertEvents(5,
+      (int) EventType::kSpiBeginTransaction,
+      (int) EventType::kSpiTransfer, 0x1 << 6,
+      (int) EventType::kSpiTransfer, 0x66,
+      (int) EventType::kSpiTransfer, 0x00,
+      (int) EventType::kSpiEndTransaction));
+}
+
+// Hc595Module routes the global brightness to the OE pin once per change,
+// without any subfields.
+Hc595Module<
+    TestableSpiInterface,
+    2 /*T_DIGITS*/,
+    1 /*T_SUBFIELDS*/,
+    TestableClockInterface,
+    TestablePwmInterface
+> hc595Module(
+    spiInterface,
+    kActiveHighPattern /*segmentOnPattern*/,
+    kActiveHighPattern /*digitOnPattern*/,
+    60 /*framesPerSecond*/,
+    kByteOrderDigitHighSegmentLow,
+    nullptr /*remapArray*/,
+    OE_PIN);
+
+test(Hc595ModuleTest, setBrightness) {
+  hc595Module.begin();
+  hc595Module.setPatternAt(0, 0x11);
+  hc595Module.setBrightness(200);
+
+  gEventLog.clear();
+  hc595Module.renderFieldNow();
+  assertTrue(gEventLog.assertEvents(2,
+      (int) EventType::kAnalogWrite, OE_PIN, 255 - 200,
+      (int) EventType::kSpiSend16, ((0x1 << 0) << 8) | 0x11));
+
+  // Brightness unchanged, so the OE pin is not written again.
+  gEventLog.clear();
+  hc595Module.renderFieldNow();
+  assertTrue(gEventLog.assertEvents(1,
+      (int) EventType::kSpiSend16, ((0x1 << 1) << 8) | 0x00));
+
+  hc595Module.end();
+}
+
+// begin() sets the full duty cycle, and a brightness of 0 turns off all
+// digits, which counts as dark for the automatic power-down.
+test(Hc595ModuleTest, zeroBrightnessIsDark) {
+  hc595Module.begin();
+  assertEqual(255, hc595Module.getBrightness());
+  hc595Module.setPatternAt(0, 0x11);
+  hc595Module.setAutoPowerDown(true);
+
+  gEventLog.clear();
+  hc595Module.renderFieldNow();
+  assertFalse(hc595Module.isPoweredDown());
+  assertTrue(gEventLog.assertEvents(2,
+      (int) EventType::kAnalogWrite, OE_PIN, 0,
+      (int) EventType::kSpiSend16, ((0x1 << 0) << 8) | 0x11));
+  hc595Module.renderFieldNow(); // finish the frame
+
+  hc595Module.setBrightness(0);
+  hc595Module.renderFieldNow();
+  assertTrue(hc595Module.isPoweredDown());
+
+  hc595Module.setAutoPowerDown(false);
+  hc595Module.end();
+}
+
+// With subfields, the global brightness is in units of subfields and is not
+// written to the OE pin, which stays at the full duty cycle set by begin().
+Hc595Module<
+    TestableSpiInterface,
+    2 /*T_DIGITS*/,
+    2 /*T_SUBFIELDS*/,
+    TestableClockInterface,
+    TestablePwmInterface
+> modulatedHc595Module(
+    spiInterface,
+    kActiveHighPattern /*segmentOnPattern*/,
+    kActiveHighPattern /*digitOnPattern*/,
+    60 /*framesPerSecond*/,
+    kByteOrderDigitHighSegmentLow,
+    nullptr /*remapArray*/,
+    OE_PIN);
+
+test(Hc595ModuleTest, setBrightnessWithSubFields) {
+  gEventLog.clear();
+  modulatedHc595Module.begin();
+  assertTrue(gEventLog.assertEvents(2,
+      (int) EventType::kSpiSend16, 0x0000, // clear()
+      (int) EventType::kAnalogWrite, OE_PIN, 0));
+
+  modulatedHc595Module.setPatternAt(0, 0x11);
+  modulatedHc595Module.setBrightness(1);
+
+  // Digit 0 is on for 1 of 2 subfields.
+  gEventLog.clear();
+  modulatedHc595Module.renderFieldNow();
+  modulatedHc595Module.renderFieldNow();
+  assertTrue(gEventLog.assertEvents(2,
+      (int) EventType::kSpiSend16, ((0x1 << 0) << 8) | 0x11,
+      (int) EventType::kSpiSend16, ((0x1 << 0) << 8) | 0x00));
+
+  modulatedHc595Module.end();
+}
+
+// A compile-time remap sends digit 0 to the physical group 4, without a RAM
+// copy of the inverted remap array.
+Hc595Module<
+    TestableSpiInterface,
+    8 /*T_DIGITS*/,
+    1 /*T_SUBFIELDS*/,
+    TestableClockInterface,
+    NullPwmInterface,
+    DigitRemap8Hc595
+> hc595RemapModule(
+    spiInterface,
+    kActiveHighPattern /*segmentOnPattern*/,
+    kActiveHighPattern /*digitOnPattern*/,
+    60 /*framesPerSecond*/,
+    kByteOrderDigitHighSegmentLow);
+
+test(Hc595ModuleTest, remapSequence) {
+  hc595RemapModule.begin();
+  hc595RemapModule.setPatternAt(0, 0x11);
+
+  gEventLog.clear();
+  hc595RemapModule.renderFieldNow();
+  assertTrue(gEventLog.assertEvents(1,
+      (int) EventType::kSpiSend16, ((0x1 << 4) << 8) | 0x11));
+
+  hc595RemapModule.end();
+}
+
+// The convenience modules embed their LedMatrix, instead of holding a
+// reference to it like a plain ScanningModule.
+test(Hc595ModuleTest, ownedLedMatrix) {
+  const uint8_t* begin = (const uint8_t*) &hc595Module;
+  const uint8_t* matrix = (const uint8_t*) &hc595Module.getLedMatrix();
+  assertTrue(matrix >= begin);
+  assertTrue(matrix < begin + sizeof(hc595Module));
+
+  using LedMatrix = LedMatrixDirect<TestableGpioInterface>;
+  using RefModule = ScanningModule<LedMatrix, 4, 1, TestableClockInterface>;
+  using OwnedModule =
+      DirectModule<4, 1, TestableClockInterface, TestableGpioInterface>;
+  assertLess(sizeof(OwnedModule), sizeof(RefModule) + sizeof(LedMatrix));
+}
+
 //-----------------------------------------------------------------------------
 
 void setup() {
@@ -10,9 +10,12 @@
 #include <AUnitVerbose.h>
 #include <AceSegment.h>
 #include <ace_segment/testing/TestableSpiInterface.h>
+#include <ace_segment/testing/EventLog.h>
 
 using aunit::TestRunner;
 using ace_segment::testing::TestableSpiInterface;
+using ace_segment::testing::EventType;
+using ace_segment::testing::gEventLog;
 using ace_segment::Max7219Module;
 using ace_segment::internal::convertPatternMax7219;
 
@@ -43,6 +46,88 @@ test(Max7219ModuleTest, isFlushRequired) {
   max7219Module.end();
 }
 
+test(Max7219ModuleTest, autoPowerDown) {
+  max7219Module.begin();
+  max7219Module.setAutoPowerDown(true);
+
+  // A blank display shuts down the chip, and nothing else is sent.
+  gEventLog.clear();
+  max7219Module.flush();
+  assertTrue(max7219Module.isPoweredDown());
+  assertTrue(gEventLog.assertEvents(
+      1, (int) EventType::kSpiSend16, 0x0C00)); // kRegisterShutdown, off
+
+  max7219Module.setBrightness(2);
+  gEventLog.clear();
+  max7219Module.flush();
+  assertEqual(0, gEventLog.getNumRecords());
+  assertFalse(max7219Module.isFlushRequired());
+
+  // A non-blank digit sends everything, then turns the chip back on.
+  max7219Module.setPatternAt(7, 0x01);
+  gEventLog.clear();
+  max7219Module.flush();
+  assertFalse(max7219Module.isPoweredDown());
+  assertEqual(NUM_DIGITS + 2, gEventLog.getNumRecords());
+  assertTrue(gEventLog.assertEvents(
+      NUM_DIGITS + 2,
+      (int) EventType::kSpiSend16, 0x0100,
+      (int) EventType::kSpiSend16, 0x0200,
+      (int) EventType::kSpiSend16, 0x0300,
+      (int) EventType::kSpiSend16, 0x0400,
+      (int) EventType::kSpiSend16, 0x0500,
+      (int) EventType::kSpiSend16, 0x0600,
+      (int) EventType::kSpiSend16, 0x0700,
+      (int) EventType::kSpiSend16, 0x0840, // segment A is bit 6
+      (int) EventType::kSpiSend16, 0x0A02, // kRegisterIntensity
+      (int) EventType::kSpiSend16, 0x0C01)); // kRegisterShutdown, on
+
+  max7219Module.setAutoPowerDown(false);
+  max7219Module.end();
+}
+
+test(Max7219ModuleTest, step) {
+  max7219Module.begin();
+  assertFalse(max7219Module.step(4));
+
+  max7219Module.setPatternAt(1, 0x01);
+  max7219Module.setBrightness(3);
+  max7219Module.startFlush();
+  assertFalse(max7219Module.isFlushRequired());
+
+  // A budget of 5 bytes fits 2 registers.
+  gEventLog.clear();
+  assertTrue(max7219Module.step(5));
+  assertTrue(gEventLog.assertEvents(
+      2,
+      (int) EventType::kSpiSend16, 0x0100,
+      (int) EventType::kSpiSend16, 0x0240)); // segment A is bit 6
+
+  // A budget smaller than a register still writes one register.
+  gEventLog.clear();
+  assertTrue(max7219Module.step(0));
+  assertEqual(1, gEventLog.getNumRecords());
+
+  // The rest of the digits, then the intensity.
+  gEventLog.clear();
+  assertFalse(max7219Module.step(255));
+  assertTrue(gEventLog.assertEvents(
+      6,
+      (int) EventType::kSpiSend16, 0x0400,
+      (int) EventType::kSpiSend16, 0x0500,
+      (int) EventType::kSpiSend16, 0x0600,
+      (int) EventType::kSpiSend16, 0x0700,
+      (int) EventType::kSpiSend16, 0x0800,
+      (int) EventType::kSpiSend16, 0x0A03)); // kRegisterIntensity
+
+  // The flush is done.
+  gEventLog.clear();
+  assertFalse(max7219Module.step(255));
+  assertEqual(0, gEventLog.getNumRecords());
+
+  max7219Module.end();
+}
+
 //----------------------------------------------------------------------------
 
 void setup() {
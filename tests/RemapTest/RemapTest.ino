@@ -12,6 +12,8 @@
 
 using aunit::TestRunner;
 using ace_segment::internal::invertRemapArray;
+using ace_segment::RemapArray;
+using ace_segment::RemapSequence;
 
 //----------------------------------------------------------------------------
 
@@ -44,6 +46,37 @@ test(invertRemapArray, permuted) {
   assertEqual(3, invertedArray[3]);
 }
 
+//----------------------------------------------------------------------------
+
+test(RemapArrayTest, remap) {
+  const uint8_t remapArray[4] = {1, 2, 0, 3};
+  RemapArray remap(remapArray);
+  assertTrue(remap.isRemapped());
+  assertEqual(1, remap.remap(0));
+  assertEqual(0, remap.remap(2));
+
+  RemapArray noRemap(nullptr);
+  assertFalse(noRemap.isRemapped());
+  assertEqual(2, noRemap.remap(2));
+}
+
+// The compile-time remap is the same as the permuted remapArray above, and its
+// Inverse is the same as the inverted array.
+test(RemapSequenceTest, remap) {
+  using Remap = RemapSequence<1, 2, 0, 3>;
+  static_assert(Remap::remap(2) == 0, "remap() must be constexpr");
+
+  assertEqual(1, Remap::remap(0));
+  assertEqual(2, Remap::remap(1));
+  assertEqual(0, Remap::remap(2));
+  assertEqual(3, Remap::remap(3));
+
+  assertEqual(2, Remap::Inverse::remap(0));
+  assertEqual(0, Remap::Inverse::remap(1));
+  assertEqual(1, Remap::Inverse::remap(2));
+  assertEqual(3, Remap::Inverse::remap(3));
+}
+
 
 //----------------------------------------------------------------------------
 
@@ -7,6 +7,7 @@
 #include <ace_segment/testing/EventLog.h>
 #include <ace_segment/testing/TestableClockInterface.h>
 #include <ace_segment/testing/TestableLedMatrix.h>
+#include <ace_segment/testing/TestableTimerInterface.h>
 
 using aunit::TestRunner;
 using aunit::TestOnce;
@@ -83,7 +84,8 @@ test(ScanningModuleTest, renderFieldNow) {
 }
 
 // A subclass of ScanningModule must render the digits and segments
-// continuously. So renderFieldNow() will never reset the digit dirty bits.
+// continuously. So in the default digit-major mode, renderFieldNow() will never
+// reset the digit dirty bits.
 test(ScanningModuleTest, isAnyDigitDirty) {
   scanningModule.begin();
   assertTrue(scanningModule.isAnyDigitDirty());
@@ -109,6 +111,667 @@ test(ScanningModuleTest, isBrightnessDirty) {
 
   scanningModule.end();
 }
+
+// A busy loop() polls renderFieldWhenReady() continuously. A tickless loop()
+// sleeps for getMicrosUntilNextField(), which needs about one iteration per
+// field.
+test(ScanningModuleTest, getMicrosUntilNextField) {
+  const uint32_t DURATION_MICROS = 100000;
+  const uint16_t POLL_MICROS = 50; // duration of one busy loop() iteration
+
+  TestableClockInterface::setMicros(0);
+  scanningModule.begin();
+  assertEqual((uint32_t) 4166, scanningModule.getMicrosUntilNextField());
+  TestableClockInterface::setMicros(4000);
+  assertEqual((uint32_t) 166, scanningModule.getMicrosUntilNextField());
+  TestableClockInterface::setMicros(5000);
+  assertEqual((uint32_t) 0, scanningModule.getMicrosUntilNextField());
+
+  // Busy polling.
+  TestableClockInterface::setMicros(0);
+  scanningModule.begin();
+  uint16_t busyIterations = 0;
+  uint16_t busyFields = 0;
+  while (TestableClockInterface::sMicros < DURATION_MICROS) {
+    busyIterations++;
+    if (scanningModule.renderFieldWhenReady()) busyFields++;
+    TestableClockInterface::sMicros += POLL_MICROS;
+  }
+
+  // Tickless loop.
+  TestableClockInterface::setMicros(0);
+  scanningModule.begin();
+  uint16_t ticklessIterations = 0;
+  uint16_t ticklessFields = 0;
+  while (TestableClockInterface::sMicros < DURATION_MICROS) {
+    ticklessIterations++;
+    if (scanningModule.renderFieldWhenReady()) ticklessFields++;
+    TestableClockInterface::sMicros +=
+        scanningModule.getMicrosUntilNextField();
+  }
+
+  // 100 ms at 4166 micros per field is 24 fields.
+  assertEqual(2000, busyIterations);
+  assertEqual(23, busyFields); // the polling delay makes each field late
+  assertEqual(24, ticklessFields);
+  assertLessOrEqual(ticklessIterations, ticklessFields + 1);
+
+  scanningModule.end();
+}
+
+test(ScanningModuleTest, autoPowerDown) {
+  scanningModule.begin();
+  scanningModule.setAutoPowerDown(true);
+
+  // A blank display is cleared once, then nothing is drawn.
+  ledMatrix.mEventLog.clear();
+  scanningModule.renderFieldNow();
+  assertTrue(scanningModule.isPoweredDown());
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixClear));
+  assertEqual(kMicrosNoDeadline, scanningModule.getMicrosUntilNextField());
+
+  ledMatrix.mEventLog.clear();
+  scanningModule.renderFieldNow();
+  assertEqual(0, ledMatrix.mEventLog.getNumRecords());
+
+  // Scanning resumes from digit 0 after a digit is lit.
+  scanningModule.setPatternAt(2, 0x22);
+  assertNotEqual(kMicrosNoDeadline, scanningModule.getMicrosUntilNextField());
+  ledMatrix.mEventLog.clear();
+  scanningModule.renderFieldNow();
+  assertFalse(scanningModule.isPoweredDown());
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0x00));
+
+  scanningModule.setAutoPowerDown(false);
+  scanningModule.end();
+}
+
+// ----------------------------------------------------------------------
+// Tests for ScanningModule in segment-major mode
+// ----------------------------------------------------------------------
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    NUM_SUB_FIELDS,
+    TestableClockInterface,
+    kScanSegmentMajor
+> segmentModule(ledMatrix, FRAMES_PER_SECOND);
+
+test(ScanningModuleTest, segmentMajor) {
+  segmentModule.begin();
+  assertEqual(8, segmentModule.getFieldsPerFrame());
+
+  segmentModule.setPatternAt(0, 0x01);
+  segmentModule.setPatternAt(1, 0x03);
+  segmentModule.setPatternAt(2, 0x80);
+  segmentModule.setPatternAt(3, 0x00);
+
+  // First field transposes the dirty digits, and draws segment 0.
+  ledMatrix.mEventLog.clear();
+  segmentModule.renderFieldNow();
+  assertFalse(segmentModule.isAnyDigitDirty());
+  assertEqual(0x03, segmentModule.getSegmentPattern(0));
+  assertEqual(0x02, segmentModule.getSegmentPattern(1));
+  assertEqual(0x04, segmentModule.getSegmentPattern(7));
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0x03));
+
+  // A change in the middle of the frame is applied on the next frame.
+  segmentModule.setPatternAt(3, 0x02);
+
+  ledMatrix.mEventLog.clear();
+  segmentModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 1, 0x02));
+
+  for (uint8_t segment = 2; segment < 7; segment++) {
+    segmentModule.renderFieldNow();
+  }
+  ledMatrix.mEventLog.clear();
+  segmentModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 7, 0x04));
+
+  // Next frame picks up the change to digit 3.
+  segmentModule.renderFieldNow();
+  ledMatrix.mEventLog.clear();
+  segmentModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 1, 0x0A));
+
+  segmentModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    2 /*T_SUBFIELDS*/,
+    TestableClockInterface,
+    kScanSegmentMajor
+> modulatedSegmentModule(ledMatrix, FRAMES_PER_SECOND);
+
+test(ScanningModuleTest, segmentMajorModulated) {
+  modulatedSegmentModule.begin();
+  assertEqual(16, modulatedSegmentModule.getFieldsPerFrame());
+
+  modulatedSegmentModule.setPatternAt(0, 0x01);
+  modulatedSegmentModule.setPatternAt(1, 0x01);
+  modulatedSegmentModule.setBrightness(2);
+  modulatedSegmentModule.renderFieldNow(); // transfer global brightness
+  modulatedSegmentModule.setBrightnessAt(1, 1);
+
+  // Finish the first frame.
+  for (uint8_t i = 1; i < 16; i++) {
+    modulatedSegmentModule.renderFieldNow();
+  }
+
+  // Subfield 0 of segment 0: both digits on.
+  ledMatrix.mEventLog.clear();
+  modulatedSegmentModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0x03));
+
+  // Subfield 1 of segment 0: digit 1 is at half brightness, so it is off.
+  ledMatrix.mEventLog.clear();
+  modulatedSegmentModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0x01));
+
+  modulatedSegmentModule.end();
+}
+
+// ----------------------------------------------------------------------
+// Tests for ScanningModule in skip-blank-digits mode
+// ----------------------------------------------------------------------
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    NUM_SUB_FIELDS,
+    TestableClockInterface,
+    kScanSkipBlankDigits
+> skipBlankModule(ledMatrix, FRAMES_PER_SECOND);
+
+test(ScanningModuleTest, skipBlankDigits) {
+  skipBlankModule.begin();
+  assertEqual(kBlankPolicyBrighter, skipBlankModule.getBlankPolicy());
+  skipBlankModule.setPatternAt(0, 0x00);
+  skipBlankModule.setPatternAt(1, 0x11);
+  skipBlankModule.setPatternAt(2, 0x00);
+  skipBlankModule.setPatternAt(3, 0x33);
+
+  // Only digits 1 and 3 are scanned, at the same field rate.
+  ledMatrix.mEventLog.clear();
+  skipBlankModule.renderFieldNow();
+  skipBlankModule.renderFieldNow();
+  skipBlankModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      3,
+      (int) EventType::kLedMatrixDraw, 1, 0x11,
+      (int) EventType::kLedMatrixDraw, 3, 0x33,
+      (int) EventType::kLedMatrixDraw, 1, 0x11));
+  assertEqual(2, skipBlankModule.getNumScanGroups());
+  assertEqual(4166, skipBlankModule.getMicrosPerField());
+
+  // The keys of the blank digits are not sampled, so they read as released.
+  ledMatrix.mKeyBits = 0xF;
+  assertEqual((uint32_t) 0xA, skipBlankModule.readButtonBits());
+  ledMatrix.mKeyBits = 0;
+
+  // The lower rate policy keeps 60 frames/sec with 2 fields per frame.
+  skipBlankModule.setBlankPolicy(kBlankPolicyLowerRate);
+  assertEqual(8333, skipBlankModule.getMicrosPerField());
+
+  // The scan set is recomputed at the start of the next frame.
+  skipBlankModule.setPatternAt(0, 0x01);
+  ledMatrix.mEventLog.clear();
+  skipBlankModule.renderFieldNow();
+  skipBlankModule.renderFieldNow();
+  skipBlankModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      3,
+      (int) EventType::kLedMatrixDraw, 3, 0x33,
+      (int) EventType::kLedMatrixDraw, 0, 0x01,
+      (int) EventType::kLedMatrixDraw, 1, 0x11));
+  assertEqual(3, skipBlankModule.getNumScanGroups());
+  assertEqual(5555, skipBlankModule.getMicrosPerField());
+
+  // All blank digits still draws one blank field.
+  for (uint8_t i = 0; i < NUM_DIGITS; i++) {
+    skipBlankModule.setPatternAt(i, 0);
+  }
+  skipBlankModule.renderFieldNow(); // finish the frame
+  skipBlankModule.renderFieldNow();
+  assertEqual(1, skipBlankModule.getNumScanGroups());
+  assertEqual(16666, skipBlankModule.getMicrosPerField());
+
+  // A single field per frame at 10 frames/sec would be 100000 micros, which
+  // is clamped to the 16-bit period. A frame rate of 0 is treated as 1.
+  skipBlankModule.setFramesPerSecond(10);
+  assertEqual((uint16_t) UINT16_MAX, skipBlankModule.getMicrosPerField());
+  skipBlankModule.setFramesPerSecond(0);
+  assertEqual(1, skipBlankModule.getFramesPerSecond());
+  assertEqual((uint16_t) UINT16_MAX, skipBlankModule.getMicrosPerField());
+  skipBlankModule.setFramesPerSecond(FRAMES_PER_SECOND);
+
+  skipBlankModule.setBlankPolicy(kBlankPolicyBrighter);
+  skipBlankModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    4 /*T_SUBFIELDS*/,
+    TestableClockInterface,
+    kScanSkipBlankDigits
+> modulatedSkipBlankModule(ledMatrix, FRAMES_PER_SECOND);
+
+test(ScanningModuleTest, skipBlankDigitsConstantBrightness) {
+  modulatedSkipBlankModule.begin();
+  modulatedSkipBlankModule.setBlankPolicy(kBlankPolicyConstantBrightness);
+  modulatedSkipBlankModule.setPatternAt(1, 0x11);
+  modulatedSkipBlankModule.setPatternAt(3, 0x33);
+
+  // Half brightness is 2 of 4 subfields. With 2 of 4 digits scanned, each
+  // digit is scanned twice as often, so it is on for only 1 subfield.
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 8; i++) {
+    modulatedSkipBlankModule.renderFieldNow();
+  }
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      4,
+      (int) EventType::kLedMatrixDraw, 1, 0x11,
+      (int) EventType::kLedMatrixDraw, 1, 0x00,
+      (int) EventType::kLedMatrixDraw, 3, 0x33,
+      (int) EventType::kLedMatrixDraw, 3, 0x00));
+
+  modulatedSkipBlankModule.end();
+}
+
+// ----------------------------------------------------------------------
+// Tests for ScanningModule in dual-bank mode
+// ----------------------------------------------------------------------
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    1 /*T_SUBFIELDS*/,
+    TestableClockInterface,
+    kScanDualBank
+> dualBankModule(ledMatrix, FRAMES_PER_SECOND);
+
+test(ScanningModuleTest, dualBank) {
+  dualBankModule.begin();
+  dualBankModule.setPatternAt(0, 0x00);
+  dualBankModule.setPatternAt(1, 0x11);
+  dualBankModule.setPatternAt(2, 0x22);
+  dualBankModule.setPatternAt(3, 0x33);
+
+  // Digits 0,1 are in bank A, and digits 2,3 are in bank B, so a frame takes
+  // only 2 fields.
+  assertEqual(2, dualBankModule.getFieldsPerFrame());
+  ledMatrix.mEventLog.clear();
+  dualBankModule.renderFieldNow();
+  dualBankModule.renderFieldNow();
+  dualBankModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      3,
+      (int) EventType::kLedMatrixDrawBanks, 0, 0x00, 0x22,
+      (int) EventType::kLedMatrixDrawBanks, 1, 0x11, 0x33,
+      (int) EventType::kLedMatrixDrawBanks, 0, 0x00, 0x22));
+
+  dualBankModule.end();
+}
+
+// ----------------------------------------------------------------------
+// Tests for ScanningModule with temporal dithering
+// ----------------------------------------------------------------------
+
+ScanningModule<
+    TestableLedMatrix,
+    2 /*T_DIGITS*/,
+    4 /*T_SUBFIELDS*/,
+    TestableClockInterface,
+    kScanDigitMajor,
+    2 /*T_DITHER_BITS*/
+> ditheredModule(ledMatrix, FRAMES_PER_SECOND);
+
+test(ScanningModuleTest, dithering) {
+  // 4 subfields with 2 bits of dithering gives 16 brightness levels.
+  assertEqual(16, (uint8_t) ditheredModule.kMaxBrightness);
+  ditheredModule.begin();
+  ditheredModule.setPatternAt(0, 0x11);
+  ditheredModule.setPatternAt(1, 0x22);
+  ditheredModule.setBrightness(6);
+
+  // 6/16 of the time is 1.5 of 4 subfields, so the digits alternate between
+  // 1 and 2 subfields across frames.
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 8; i++) {
+    ditheredModule.renderFieldNow();
+  }
+  assertEqual(1, ditheredModule.getFrameBrightnessAt(0));
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      4,
+      (int) EventType::kLedMatrixDraw, 0, 0x11,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 1, 0x22,
+      (int) EventType::kLedMatrixDraw, 1, 0x00));
+
+  uint8_t totalLevels = 0;
+  for (uint8_t frame = 0; frame < 4; frame++) {
+    for (uint8_t i = 0; i < 8; i++) {
+      ditheredModule.renderFieldNow();
+    }
+    assertEqual((frame & 0x1) ? 1 : 2, ditheredModule.getFrameBrightnessAt(1));
+    totalLevels += ditheredModule.getFrameBrightnessAt(0);
+  }
+  assertEqual(6, totalLevels);
+
+  // The maximum brightness keeps the digit on in all subfields.
+  ditheredModule.setBrightnessAt(0, 255);
+  for (uint8_t i = 0; i < 8; i++) {
+    ditheredModule.renderFieldNow();
+  }
+  assertEqual(4, ditheredModule.getFrameBrightnessAt(0));
+
+  ditheredModule.end();
+}
+
+// ----------------------------------------------------------------------
+// Tests for ScanningModule with interleaved and spread scan orders
+// ----------------------------------------------------------------------
+
+test(ScanningModuleTest, scanOrderTables) {
+  using Interleaved = internal::ScanOrderTable<5, false>;
+  assertEqual(0, Interleaved::valueAt(0));
+  assertEqual(2, Interleaved::valueAt(1));
+  assertEqual(4, Interleaved::valueAt(2));
+  assertEqual(1, Interleaved::valueAt(3));
+  assertEqual(3, Interleaved::valueAt(4));
+
+  // Bit-reversed order of 3 bits, skipping 5, 6 and 7.
+  using Spread = internal::ScanOrderTable<5, true>;
+  assertEqual(0, Spread::valueAt(0));
+  assertEqual(4, Spread::valueAt(1));
+  assertEqual(2, Spread::valueAt(2));
+  assertEqual(1, Spread::valueAt(3));
+  assertEqual(3, Spread::valueAt(4));
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    NUM_DIGITS,
+    1 /*T_SUBFIELDS*/,
+    TestableClockInterface,
+    kScanDigitMajor,
+    0 /*T_DITHER_BITS*/,
+    kScanOrderInterleaved
+> interleavedModule(ledMatrix, FRAMES_PER_SECOND);
+
+test(ScanningModuleTest, interleavedScanOrder) {
+  interleavedModule.begin();
+  interleavedModule.setPatternAt(0, 0x00);
+  interleavedModule.setPatternAt(1, 0x11);
+  interleavedModule.setPatternAt(2, 0x22);
+  interleavedModule.setPatternAt(3, 0x33);
+
+  // The even digits are scanned first, then the odd digits.
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < NUM_DIGITS; i++) {
+    interleavedModule.renderFieldNow();
+  }
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      4,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 2, 0x22,
+      (int) EventType::kLedMatrixDraw, 1, 0x11,
+      (int) EventType::kLedMatrixDraw, 3, 0x33));
+
+  interleavedModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    2 /*T_DIGITS*/,
+    4 /*T_SUBFIELDS*/,
+    TestableClockInterface,
+    kScanDigitMajor,
+    0 /*T_DITHER_BITS*/,
+    kScanOrderSpreadSubFields
+> spreadModule(ledMatrix, FRAMES_PER_SECOND);
+
+test(ScanningModuleTest, spreadSubFieldsScanOrder) {
+  spreadModule.begin();
+  spreadModule.setPatternAt(0, 0x11);
+  spreadModule.setPatternAt(1, 0x22);
+  spreadModule.setBrightness(2);
+
+  // Each subfield scans both digits. The subfield ranks are "0 2 1 3", so
+  // the digits at half brightness are on in the 1st and 3rd subfields, instead
+  // of the first half of their slots.
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 8; i++) {
+    spreadModule.renderFieldNow();
+  }
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      8,
+      (int) EventType::kLedMatrixDraw, 0, 0x11,
+      (int) EventType::kLedMatrixDraw, 1, 0x22,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 1, 0x00,
+      (int) EventType::kLedMatrixDraw, 0, 0x11,
+      (int) EventType::kLedMatrixDraw, 1, 0x22,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 1, 0x00));
+
+  spreadModule.end();
+}
+
+using PackedModule = ScanningModule<
+    TestableLedMatrix,
+    3 /*T_DIGITS*/,
+    4 /*T_SUBFIELDS*/,
+    TestableClockInterface
+>;
+PackedModule packedModule(ledMatrix, FRAMES_PER_SECOND);
+
+test(ScanningModuleTest, packedBrightnesses) {
+  // Up to 15 brightness levels are packed 2 digits per byte.
+  using UnpackedModule = ScanningModule<TestableLedMatrix, 3, 16>;
+  assertTrue((bool) PackedModule::kPackBrightnesses);
+  assertFalse((bool) UnpackedModule::kPackBrightnesses);
+
+  packedModule.begin();
+  packedModule.setPatternAt(0, 0x11);
+  packedModule.setPatternAt(1, 0x22);
+  packedModule.setPatternAt(2, 0x33);
+
+  // The first frame transfers the global brightness of begin().
+  for (uint8_t i = 0; i < 12; i++) {
+    packedModule.renderFieldNow();
+  }
+  packedModule.setBrightnessAt(0, 1);
+  packedModule.setBrightnessAt(1, 3);
+  packedModule.setBrightnessAt(2, 9); // clamped to 4
+
+  // Each digit is on for the first `brightness` subfields, and the
+  // LedMatrix is drawn only when the pattern changes.
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 12; i++) {
+    packedModule.renderFieldNow();
+  }
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      5,
+      (int) EventType::kLedMatrixDraw, 0, 0x11,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 1, 0x22,
+      (int) EventType::kLedMatrixDraw, 1, 0x00,
+      (int) EventType::kLedMatrixDraw, 2, 0x33));
+
+  packedModule.end();
+}
+
+// ----------------------------------------------------------------------
+// Tests for ScanningTimer w/ a TestableTimerInterface
+// ----------------------------------------------------------------------
+
+ScanningTimer<decltype(scanningModule), TestableTimerInterface>
+    scanningTimer(scanningModule);
+
+test(ScanningTimerTest, interrupts) {
+  scanningModule.begin();
+  scanningModule.setPatternAt(0, 0x00);
+  scanningModule.setPatternAt(1, 0x11);
+  scanningModule.setPatternAt(2, 0x22);
+  scanningModule.setPatternAt(3, 0x33);
+
+  // 60 frames/sec * 4 fields/frame = 4166 micros/field
+  scanningTimer.begin();
+  assertEqual((uint32_t) 4166, TestableTimerInterface::sPeriodMicros);
+
+  // No interrupt until a full period has elapsed.
+  ledMatrix.mEventLog.clear();
+  TestableTimerInterface::advanceMicros(4165);
+  assertEqual(0, ledMatrix.mEventLog.getNumRecords());
+
+  // Each interrupt renders one field.
+  TestableTimerInterface::advanceMicros(1 + 4166);
+  assertEqual(2, TestableTimerInterface::sNumInterrupts);
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      2,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 1, 0x11));
+
+  // No more interrupts after end().
+  scanningTimer.end();
+  ledMatrix.mEventLog.clear();
+  TestableTimerInterface::advanceMicros(10000);
+  assertEqual(0, ledMatrix.mEventLog.getNumRecords());
+
+  scanningModule.end();
+}
+
+test(ScanningTimerTest, setFramesPerSecond) {
+  scanningModule.begin();
+  scanningTimer.begin();
+  TestableTimerInterface::sNumPeriodChanges = 0;
+
+  // 100 frames/sec * 4 fields/frame = 2500 micros/field
+  scanningTimer.setFramesPerSecond(100);
+  assertEqual(100, scanningModule.getFramesPerSecond());
+  assertEqual(2500, scanningModule.getMicrosPerField());
+  assertEqual((uint32_t) 2500, TestableTimerInterface::sPeriodMicros);
+  assertEqual(1, TestableTimerInterface::sNumPeriodChanges);
+
+  // Nothing to reprogram if the period did not change.
+  assertFalse(scanningTimer.sync());
+  assertEqual(1, TestableTimerInterface::sNumPeriodChanges);
+
+  // A change made directly on the module is picked up by sync().
+  scanningModule.setFramesPerSecond(FRAMES_PER_SECOND);
+  assertTrue(scanningTimer.sync());
+  assertEqual((uint32_t) 4166, TestableTimerInterface::sPeriodMicros);
+
+  scanningTimer.end();
+  scanningModule.end();
+}
+
+ScanningTimer<decltype(skipBlankModule), TestableTimerInterface>
+    skipBlankTimer(skipBlankModule);
+
+test(ScanningTimerTest, lowerRatePeriod) {
+  skipBlankModule.begin();
+  skipBlankModule.setBlankPolicy(kBlankPolicyLowerRate);
+  skipBlankModule.setPatternAt(1, 0x11);
+  skipBlankModule.setPatternAt(3, 0x33);
+  skipBlankTimer.begin();
+  TestableTimerInterface::sNumPeriodChanges = 0;
+  assertEqual((uint32_t) 4166, TestableTimerInterface::sPeriodMicros);
+
+  // The first field computes the scan set of 2 digits, and the isr reprograms
+  // the timer to keep 60 frames/sec with 2 fields per frame.
+  ledMatrix.mEventLog.clear();
+  TestableTimerInterface::advanceMicros(4166);
+  assertEqual(1, TestableTimerInterface::sNumPeriodChanges);
+  assertEqual((uint32_t) 8333, TestableTimerInterface::sPeriodMicros);
+  assertEqual(8333, skipBlankTimer.getMicrosPerField());
+
+  TestableTimerInterface::advanceMicros(8333);
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      2,
+      (int) EventType::kLedMatrixDraw, 1, 0x11,
+      (int) EventType::kLedMatrixDraw, 3, 0x33));
+
+  skipBlankTimer.end();
+  skipBlankModule.setBlankPolicy(kBlankPolicyBrighter);
+  skipBlankModule.end();
+}
+
+// ----------------------------------------------------------------------
+// Tests for FrameRateGovernor
+// ----------------------------------------------------------------------
+
+FrameRateGovernor<decltype(scanningModule), TestableClockInterface>
+    governor(scanningModule, 30 /*minFps*/, 60 /*maxFps*/, 10 /*stepFps*/);
+
+// Call renderFieldWhenReady() for one window of fields, each one late by the
+// given micros.
+void renderWindow(uint16_t latenessMicros) {
+  uint16_t numFields = decltype(governor)::kFramesPerWindow
+      * scanningModule.getFieldsPerFrame();
+  for (uint16_t i = 0; i < numFields; i++) {
+    TestableClockInterface::sMicros +=
+        scanningModule.getMicrosPerField() + latenessMicros;
+    governor.renderFieldWhenReady();
+  }
+}
+
+test(FrameRateGovernorTest, adjustFramesPerSecond) {
+  TestableClockInterface::setMicros(0);
+  scanningModule.begin();
+  governor.begin();
+  assertEqual(60, governor.getFramesPerSecond());
+  assertEqual(4166, scanningModule.getMicrosPerField());
+
+  // Nothing is rendered before the first field is due.
+  TestableClockInterface::setMicros(4165);
+  assertFalse(governor.renderFieldWhenReady());
+  TestableClockInterface::setMicros(0);
+
+  // Fields late by more than 1/4 of a field lower the frame rate.
+  renderWindow(2000);
+  assertEqual(2000, governor.getAverageLatenessMicros());
+  assertEqual(40, governor.getAchievedFramesPerSecond());
+  assertEqual(50, governor.getFramesPerSecond());
+  assertEqual(5000, scanningModule.getMicrosPerField());
+
+  // Down to the minimum frame rate.
+  renderWindow(2000);
+  renderWindow(2000);
+  renderWindow(2000);
+  assertEqual(30, governor.getFramesPerSecond());
+
+  // Moderate lateness leaves the frame rate unchanged.
+  renderWindow(1000);
+  assertEqual(30, governor.getFramesPerSecond());
+
+  // The frame rate is raised only after kRaiseWindows idle windows.
+  for (uint8_t i = 0; i < decltype(governor)::kRaiseWindows - 1; i++) {
+    renderWindow(0);
+  }
+  assertEqual(30, governor.getFramesPerSecond());
+  assertEqual(30, governor.getAchievedFramesPerSecond());
+  renderWindow(0);
+  assertEqual(40, governor.getFramesPerSecond());
+
+  scanningModule.setFramesPerSecond(FRAMES_PER_SECOND);
+  scanningModule.end();
+}
+
 //----------------------------------------------------------------------------
 
 void setup() {
@@ -0,0 +1,208 @@
+#line 2 "ScanningSchedulerTest.ino"
+
+/*
+ * MIT License
+ * Copyright (c) 2026 Brian T. Park
+ */
+
+#include <stdarg.h>
+#include <Arduino.h>
+#include <AUnitVerbose.h>
+#include <AceSegment.h>
+#include <ace_segment/testing/EventLog.h>
+#include <ace_segment/testing/TestableClockInterface.h>
+#include <ace_segment/testing/TestableLedMatrix.h>
+#include <ace_segment/testing/TestableTimerInterface.h>
+
+using aunit::TestRunner;
+using namespace ace_segment;
+using namespace ace_segment::testing;
+
+//----------------------------------------------------------------------------
+// 3 modules with field periods of 2000, 4000 and 4000 micros.
+//----------------------------------------------------------------------------
+
+TestableLedMatrix ledMatrixA;
+TestableLedMatrix ledMatrixB;
+TestableLedMatrix ledMatrixC;
+
+// 125 frames/sec * 4 fields/frame = 2000 micros/field
+ScanningModule<TestableLedMatrix, 4, 1, TestableClockInterface>
+    moduleA(ledMatrixA, 125);
+
+// 125 frames/sec * 2 fields/frame = 4000 micros/field
+ScanningModule<TestableLedMatrix, 2, 1, TestableClockInterface>
+    moduleB(ledMatrixB, 125);
+ScanningModule<TestableLedMatrix, 2, 1, TestableClockInterface>
+    moduleC(ledMatrixC, 125);
+
+ScanningScheduler<TestableTimerInterface, 3, TestableClockInterface>
+    scheduler(1000 /*minMicrosPerTick*/);
+
+void setupModules() {
+  moduleA.begin();
+  moduleB.begin();
+  moduleC.begin();
+  moduleA.setPatternAt(0, 0xA0);
+  moduleA.setPatternAt(1, 0xA1);
+  moduleB.setPatternAt(0, 0xB0);
+  moduleB.setPatternAt(1, 0xB1);
+  moduleC.setPatternAt(0, 0xC0);
+  moduleC.setPatternAt(1, 0xC1);
+}
+
+void clearEventLogs() {
+  ledMatrixA.mEventLog.clear();
+  ledMatrixB.mEventLog.clear();
+  ledMatrixC.mEventLog.clear();
+}
+
+test(ScanningSchedulerTest, schedule) {
+  setupModules();
+  assertEqual(3, scheduler.getNumModules());
+  assertFalse(scheduler.addModule(moduleC)); // full
+
+  // The timer runs at the GCD of the field periods.
+  scheduler.begin();
+  assertEqual(2000, scheduler.getMicrosPerTick());
+  assertEqual((uint32_t) 2000, TestableTimerInterface::sPeriodMicros);
+  assertEqual(1, scheduler.getDividerAt(0));
+  assertEqual(2, scheduler.getDividerAt(1));
+  assertEqual(2, scheduler.getDividerAt(2));
+
+  // Module A renders on every tick, so B and C alternate on the other ticks.
+  assertEqual(0, scheduler.getPhaseAt(0));
+  assertEqual(0, scheduler.getPhaseAt(1));
+  assertEqual(1, scheduler.getPhaseAt(2));
+
+  // Tick 0: A and B.
+  clearEventLogs();
+  TestableTimerInterface::advanceMicros(2000);
+  assertTrue(ledMatrixA.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0xA0));
+  assertTrue(ledMatrixB.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0xB0));
+  assertEqual(0, ledMatrixC.mEventLog.getNumRecords());
+
+  // Tick 1: A and C.
+  clearEventLogs();
+  TestableTimerInterface::advanceMicros(2000);
+  assertTrue(ledMatrixA.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 1, 0xA1));
+  assertEqual(0, ledMatrixB.mEventLog.getNumRecords());
+  assertTrue(ledMatrixC.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 0, 0xC0));
+
+  // Tick 2: A and B.
+  clearEventLogs();
+  TestableTimerInterface::advanceMicros(2000);
+  assertEqual(1, ledMatrixA.mEventLog.getNumRecords());
+  assertTrue(ledMatrixB.mEventLog.assertEvents(
+      1, (int) EventType::kLedMatrixDraw, 1, 0xB1));
+  assertEqual(0, ledMatrixC.mEventLog.getNumRecords());
+
+  scheduler.end();
+}
+
+test(ScanningSchedulerTest, jitter) {
+  setupModules();
+  scheduler.begin();
+
+  // Fields are exactly one period apart with an ideal timer.
+  TestableTimerInterface::advanceMicros(5 * 2000);
+  assertEqual(2000, scheduler.getMinFieldMicrosAt(0));
+  assertEqual(2000, scheduler.getMaxFieldMicrosAt(0));
+  assertEqual(4000, scheduler.getMinFieldMicrosAt(1));
+  assertEqual(4000, scheduler.getMaxFieldMicrosAt(1));
+  assertEqual(0, scheduler.getFieldJitterMicrosAt(1));
+
+  // Simulate an interrupt delayed by 100 micros.
+  TestableClockInterface::sMicros += 100;
+  TestableTimerInterface::advanceMicros(4 * 2000);
+  assertEqual(2100, scheduler.getMaxFieldMicrosAt(0));
+  assertEqual(100, scheduler.getFieldJitterMicrosAt(0));
+  assertEqual(4100, scheduler.getMaxFieldMicrosAt(1));
+  assertEqual(100, scheduler.getFieldJitterMicrosAt(1));
+
+  scheduler.resetJitter();
+  assertEqual(0, scheduler.getFieldJitterMicrosAt(1));
+
+  scheduler.end();
+}
+
+test(ScanningSchedulerTest, sync) {
+  setupModules();
+  scheduler.begin();
+  assertFalse(scheduler.sync());
+
+  // 250 frames/sec * 4 fields/frame = 1000 micros/field
+  moduleA.setFramesPerSecond(250);
+  uint16_t numPeriodChanges = TestableTimerInterface::sNumPeriodChanges;
+  assertTrue(scheduler.sync());
+  assertEqual(numPeriodChanges + 1, TestableTimerInterface::sNumPeriodChanges);
+  assertEqual(1000, scheduler.getMicrosPerTick());
+  assertEqual((uint32_t) 1000, TestableTimerInterface::sPeriodMicros);
+  assertEqual(1, scheduler.getDividerAt(0));
+  assertEqual(4, scheduler.getDividerAt(1));
+  assertEqual(4, scheduler.getDividerAt(2));
+  assertEqual(0, scheduler.getPhaseAt(1));
+  assertEqual(1, scheduler.getPhaseAt(2));
+  assertFalse(scheduler.sync());
+
+  moduleA.setFramesPerSecond(125);
+  assertTrue(scheduler.sync());
+  assertEqual(2000, scheduler.getMicrosPerTick());
+
+  scheduler.end();
+}
+
+//----------------------------------------------------------------------------
+// Field periods with a small common divisor are limited by minMicrosPerTick.
+//----------------------------------------------------------------------------
+
+// 60 frames/sec * 4 fields/frame = 4166 micros/field
+ScanningModule<TestableLedMatrix, 4, 1, TestableClockInterface>
+    module60(ledMatrixA, 60);
+
+// 50 frames/sec * 4 fields/frame = 5000 micros/field
+ScanningModule<TestableLedMatrix, 4, 1, TestableClockInterface>
+    module50(ledMatrixB, 50);
+
+ScanningScheduler<TestableTimerInterface, 2, TestableClockInterface>
+    roundingScheduler(1000 /*minMicrosPerTick*/);
+
+test(ScanningSchedulerTest, minMicrosPerTick) {
+  module60.begin();
+  module50.begin();
+  roundingScheduler.begin();
+
+  // GCD(4166, 5000) = 2, so the tick is limited to 1000 micros, and the
+  // dividers are rounded.
+  assertEqual(1000, roundingScheduler.getMicrosPerTick());
+  assertEqual(4, roundingScheduler.getDividerAt(0));
+  assertEqual(5, roundingScheduler.getDividerAt(1));
+
+  roundingScheduler.end();
+}
+
+//----------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // Wait for stability on some boards, otherwise garage on Serial
+#endif
+
+  Serial.begin(115200); // ESP8266 default of 74880 not supported on Linux
+  while (!Serial); // Wait until Serial is ready - Leonardo/Micro
+
+  // AUnit runs the tests in alphabetical order, so add the modules here.
+  scheduler.addModule(moduleA);
+  scheduler.addModule(moduleB);
+  scheduler.addModule(moduleC);
+  roundingScheduler.addModule(module60);
+  roundingScheduler.addModule(module50);
+}
+
+void loop() {
+  TestRunner::run();
+}
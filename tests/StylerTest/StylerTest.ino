@@ -0,0 +1,330 @@
+#line 2 "StylerTest.ino"
+
+/*
+ * MIT License
+ * Copyright (c) 2026 Brian T. Park
+ */
+
+#define ACE_SEGMENT_ENABLE_STYLER 1
+
+#include <stdarg.h>
+#include <Arduino.h>
+#include <AUnitVerbose.h>
+#include <AceSegment.h>
+#include <ace_segment/testing/EventLog.h>
+#include <ace_segment/testing/TestableClockInterface.h>
+#include <ace_segment/testing/TestableLedMatrix.h>
+#include <ace_segment/testing/TestableTmi1637Interface.h>
+#include <ace_segment/testing/TestableSpiInterface.h>
+#include <ace_segment/testing/TestableWireInterface.h>
+
+using aunit::TestRunner;
+using namespace ace_segment;
+using namespace ace_segment::testing;
+
+//----------------------------------------------------------------------------
+// Styler
+//----------------------------------------------------------------------------
+
+constexpr Style STYLES[] = {
+  {kStyleTypeBlink, 1000},
+  {kStyleTypePulse, 1000},
+};
+const uint8_t NUM_STYLES = sizeof(STYLES) / sizeof(STYLES[0]);
+
+Styler styler(STYLES, NUM_STYLES);
+
+test(StylerTest, setStyleAt) {
+  styler.begin();
+  styler.setStyleAt(0, 1);
+  styler.setStyleAt(7, 2);
+  styler.setStyleAt(3, 3); // invalid style ID, ignored
+  styler.setStyleAt(8, 1); // invalid position, ignored
+  assertEqual(1, styler.getStyleAt(0));
+  assertEqual(0, styler.getStyleAt(3));
+  assertEqual(2, styler.getStyleAt(7));
+
+  // The digits with new styles are reported by the next update().
+  assertEqual(0x81, styler.update(0));
+  assertEqual(0x00, styler.update(0));
+}
+
+test(StylerTest, update) {
+  styler.begin();
+  styler.setStyleAt(1, 1);
+  styler.setStyleAt(2, 2);
+  styler.update(0);
+
+  // First half of the blink period is on.
+  assertEqual(0x11, styler.applyPattern(0, 0x11));
+  assertEqual(0x22, styler.applyPattern(1, 0x22));
+  assertEqual(0x33, styler.applyPattern(2, 0x33));
+  assertEqual(0, styler.mLevels[2]);
+
+  // Second half of the blink period is off. Only digit 1 changed.
+  assertEqual(0x02, styler.update(500));
+  assertEqual(0x11, styler.applyPattern(0, 0x11));
+  assertEqual(0x00, styler.applyPattern(1, 0x22));
+  assertEqual(0x33, styler.applyPattern(2, 0x33));
+
+  // Pulse is at the peak in the middle of the period.
+  assertEqual(255, styler.mLevels[2]);
+  assertEqual(16, styler.applyBrightness(2, 16));
+  assertEqual(16, styler.applyBrightness(0, 16));
+
+  // Pulse is half way down at 3/4 of the period.
+  assertEqual(0x00, styler.update(750));
+  assertEqual(8, styler.applyBrightness(2, 16));
+  assertEqual(16, styler.applyBrightness(0, 16));
+
+  // Next period turns the blinking digit back on.
+  assertEqual(0x02, styler.update(1000));
+}
+
+constexpr Style ODD_STYLES[] = {
+  {kStyleTypePulse, 5},
+};
+Styler oddStyler(ODD_STYLES, 1);
+
+test(StylerTest, pulseOddPeriod) {
+  oddStyler.begin();
+  oddStyler.setStyleAt(0, 1);
+
+  // The period of 5 has a half of 2, and the ramp of 3 at phase 2 is clamped
+  // to the peak instead of wrapping around.
+  oddStyler.update(1);
+  assertEqual(127, oddStyler.applyBrightness(0, 255));
+  oddStyler.update(2);
+  assertEqual(255, oddStyler.applyBrightness(0, 255));
+  oddStyler.update(3);
+  assertEqual(255, oddStyler.applyBrightness(0, 255));
+  oddStyler.update(4);
+  assertEqual(127, oddStyler.applyBrightness(0, 255));
+}
+
+//----------------------------------------------------------------------------
+// Styler attached to a ScanningModule
+//----------------------------------------------------------------------------
+
+TestableLedMatrix ledMatrix;
+ScanningModule<
+    TestableLedMatrix,
+    2 /*T_DIGITS*/,
+    1 /*T_SUBFIELDS*/,
+    TestableClockInterface
+> scanningModule(ledMatrix, 60);
+
+test(StylerTest, scanningModule) {
+  styler.begin();
+  TestableClockInterface::setMillis(0);
+  scanningModule.begin();
+  scanningModule.setStyler(&styler);
+  scanningModule.setPatternAt(0, 0x11);
+  scanningModule.setPatternAt(1, 0x22);
+  styler.setStyleAt(1, 1);
+
+  // Frame at 0 millis shows both digits.
+  ledMatrix.mEventLog.clear();
+  scanningModule.renderFieldNow();
+  scanningModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      2,
+      (int) EventType::kLedMatrixDraw, 0, 0x11,
+      (int) EventType::kLedMatrixDraw, 1, 0x22));
+
+  // Styles are evaluated only at the start of the frame at 500 millis, which
+  // blanks digit 1 without changing its pattern.
+  TestableClockInterface::setMillis(500);
+  ledMatrix.mEventLog.clear();
+  scanningModule.renderFieldNow();
+  scanningModule.renderFieldNow();
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      2,
+      (int) EventType::kLedMatrixDraw, 0, 0x11,
+      (int) EventType::kLedMatrixDraw, 1, 0x00));
+  assertEqual(0x22, scanningModule.getPatternAt(1));
+
+  scanningModule.setStyler(nullptr);
+  scanningModule.end();
+}
+
+ScanningModule<
+    TestableLedMatrix,
+    2 /*T_DIGITS*/,
+    4 /*T_SUBFIELDS*/,
+    TestableClockInterface
+> modulatedModule(ledMatrix, 60);
+
+test(StylerTest, modulatedScanningModule) {
+  styler.begin();
+  TestableClockInterface::setMillis(250);
+  modulatedModule.begin();
+  modulatedModule.setStyler(&styler);
+  modulatedModule.setPatternAt(0, 0x11);
+  modulatedModule.setPatternAt(1, 0x22);
+  styler.setStyleAt(1, 2);
+
+  // At a quarter of the pulse period, digit 1 is at half of the brightness of
+  // 2 subfields set by begin(). The styled brightness is computed once at the
+  // start of the frame, and read by each field.
+  ledMatrix.mEventLog.clear();
+  for (uint8_t i = 0; i < 8; i++) {
+    modulatedModule.renderFieldNow();
+  }
+  assertTrue(ledMatrix.mEventLog.assertEvents(
+      4,
+      (int) EventType::kLedMatrixDraw, 0, 0x11,
+      (int) EventType::kLedMatrixDraw, 0, 0x00,
+      (int) EventType::kLedMatrixDraw, 1, 0x22,
+      (int) EventType::kLedMatrixDraw, 1, 0x00));
+
+  modulatedModule.setStyler(nullptr);
+  modulatedModule.end();
+}
+
+//----------------------------------------------------------------------------
+// Styler attached to a Tm1637Module
+//----------------------------------------------------------------------------
+
+TestableTmi1637Interface tmiInterface;
+using TmModule = Tm1637Module<
+    TestableTmi1637Interface, 4, TestableClockInterface>;
+TmModule tm1637Module(tmiInterface);
+
+test(StylerTest, tm1637Module) {
+  styler.begin();
+  TestableClockInterface::setMillis(0);
+  tm1637Module.begin();
+  tm1637Module.setStyler(&styler);
+  tm1637Module.setPatternAt(2, 0x22);
+  styler.setStyleAt(2, 1);
+  tm1637Module.flush();
+  assertFalse(tm1637Module.isFlushRequired());
+
+  // Halfway through the blink period, updateStyler() marks the blinking digit
+  // dirty, so a loop() which checks isFlushRequired() sees the change.
+  TestableClockInterface::setMillis(500);
+  tm1637Module.updateStyler(TestableClockInterface::millis());
+  assertTrue(tm1637Module.isFlushRequired());
+
+  // Then flushIncremental() sends only the blinking digit, with a blank
+  // pattern.
+  gEventLog.clear();
+  tm1637Module.flushIncremental();
+  assertTrue(gEventLog.assertEvents(
+      7,
+      (int) EventType::kTmi1637StartCondition,
+      (int) EventType::kTmi1637SendByte, 0b01000100, // kDataCmdFixedAddress
+      (int) EventType::kTmi1637StopCondition,
+      (int) EventType::kTmi1637StartCondition,
+      (int) EventType::kTmi1637SendByte, 0b11000000 | 2, // kAddressCmd | 2
+      (int) EventType::kTmi1637SendByte, 0x00,
+      (int) EventType::kTmi1637StopCondition
+  ));
+  assertEqual(0x22, tm1637Module.getPatternAt(2));
+
+  tm1637Module.setStyler(nullptr);
+  tm1637Module.end();
+}
+
+//----------------------------------------------------------------------------
+// Styler attached to a Max7219Module, which reads its own T_CI clock
+//----------------------------------------------------------------------------
+
+TestableSpiInterface spiInterface;
+using MaxModule = Max7219Module<
+    TestableSpiInterface, 4, TestableClockInterface>;
+MaxModule max7219Module(spiInterface);
+
+test(StylerTest, max7219Module) {
+  styler.begin();
+  TestableClockInterface::setMillis(0);
+  max7219Module.begin();
+  max7219Module.setStyler(&styler);
+  max7219Module.setPatternAt(2, 0x01);
+  styler.setStyleAt(2, 1);
+
+  // In the first half of the blink period, the digit is sent as is.
+  gEventLog.clear();
+  max7219Module.flush();
+  assertTrue(gEventLog.assertEvents(
+      5,
+      (int) EventType::kSpiSend16, 0x0100,
+      (int) EventType::kSpiSend16, 0x0200,
+      (int) EventType::kSpiSend16, 0x0340, // convertPatternMax7219(0x01)
+      (int) EventType::kSpiSend16, 0x0400,
+      (int) EventType::kSpiSend16, 0x0A01 // kRegisterIntensity
+  ));
+
+  // In the second half, flush() reads TestableClockInterface::millis() and
+  // blanks the digit.
+  TestableClockInterface::setMillis(500);
+  gEventLog.clear();
+  max7219Module.flush();
+  assertTrue(gEventLog.assertEvents(
+      5,
+      (int) EventType::kSpiSend16, 0x0100,
+      (int) EventType::kSpiSend16, 0x0200,
+      (int) EventType::kSpiSend16, 0x0300,
+      (int) EventType::kSpiSend16, 0x0400,
+      (int) EventType::kSpiSend16, 0x0A01
+  ));
+
+  max7219Module.setStyler(nullptr);
+  max7219Module.end();
+}
+
+//----------------------------------------------------------------------------
+// Styler attached to an Ht16k33Module, flushed by startFlush() and step()
+//----------------------------------------------------------------------------
+
+TestableWireInterface wireInterface;
+using HtModule = Ht16k33Module<
+    TestableWireInterface, 4, TestableClockInterface>;
+HtModule ht16k33Module(wireInterface, 0x70);
+
+test(StylerTest, ht16k33ModuleStep) {
+  styler.begin();
+  TestableClockInterface::setMillis(0);
+  ht16k33Module.begin();
+  ht16k33Module.setStyler(&styler);
+  ht16k33Module.setPatternAt(3, 0x01);
+  styler.setStyleAt(3, 1);
+
+  // The first step sends COM0-COM3, and the second step sends digit 3 to
+  // COM4 after its address. In the first half of the blink period, the digit
+  // is sent as is.
+  ht16k33Module.startFlush();
+  gEventLog.clear();
+  assertTrue(ht16k33Module.step(9));
+  assertFalse(ht16k33Module.step(255));
+  assertEqual((int) EventType::kWireWrite, (int) gEventLog.getEvent(13).type);
+  assertEqual(0x01, gEventLog.getEvent(13).arg1);
+
+  // In the second half, the digit is blanked by the step which sends it.
+  TestableClockInterface::setMillis(500);
+  ht16k33Module.startFlush();
+  gEventLog.clear();
+  assertTrue(ht16k33Module.step(9));
+  assertFalse(ht16k33Module.step(255));
+  assertEqual((int) EventType::kWireWrite, (int) gEventLog.getEvent(13).type);
+  assertEqual(0x00, gEventLog.getEvent(13).arg1);
+
+  ht16k33Module.setStyler(nullptr);
+  ht16k33Module.end();
+}
+
+//----------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // Wait for stability on some boards, otherwise garage on Serial
+#endif
+
+  Serial.begin(115200); // ESP8266 default of 74880 not supported on Linux
+  while (!Serial); // Wait until Serial is ready - Leonardo/Micro
+}
+
+void loop() {
+  TestRunner::run();
+}
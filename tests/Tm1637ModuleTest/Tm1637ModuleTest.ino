@@ -47,18 +47,10 @@ test(Tm1637ModuleTest, flushIncremental) {
   tm1637Module.setBrightness(2);
   assertTrue(tm1637Module.isBrightnessDirty());
 
-  // Iteration 0 sends digit 0, which did not change, so send nothing.
+  // Iteration 0 skips the clean digit 0, and sends digit 1.
   assertEqual(0, tm1637Module.mFlushStage);
   gEventLog.clear();
   tm1637Module.flushIncremental();
-  assertEqual(0, gEventLog.getNumRecords());
-  assertFalse(tm1637Module.isDigitDirty(0));
-  assertEqual(1, tm1637Module.mFlushStage);
-
-  // Iteration 1 sends digit 1, which changed, so send digit 1;
-  assertEqual(1, tm1637Module.mFlushStage);
-  gEventLog.clear();
-  tm1637Module.flushIncremental();
   assertEqual(7, gEventLog.getNumRecords());
   assertTrue(gEventLog.assertEvents(
     7,
@@ -73,24 +65,7 @@ test(Tm1637ModuleTest, flushIncremental) {
   assertFalse(tm1637Module.isDigitDirty(1));
   assertEqual(2, tm1637Module.mFlushStage);
 
-  // Iteration 2 sends digit 3, which sends nothing.
-  assertEqual(2, tm1637Module.mFlushStage);
-  gEventLog.clear();
-  tm1637Module.flushIncremental();
-  assertEqual(0, gEventLog.getNumRecords());
-  assertFalse(tm1637Module.isDigitDirty(2));
-  assertEqual(3, tm1637Module.mFlushStage);
-
-  // Iteration 3 sends digit 3, which sends nothing.
-  assertEqual(3, tm1637Module.mFlushStage);
-  gEventLog.clear();
-  tm1637Module.flushIncremental();
-  assertEqual(0, gEventLog.getNumRecords());
-  assertFalse(tm1637Module.isDigitDirty(3));
-  assertEqual(4, tm1637Module.mFlushStage);
-
-  // Iteration 4 sends brightness, which changed, so sends package.
-  assertEqual(4, tm1637Module.mFlushStage);
+  // Iteration 1 skips the clean digits 2 and 3, and sends the brightness.
   gEventLog.clear();
   tm1637Module.flushIncremental();
   assertEqual(3, gEventLog.getNumRecords());
@@ -101,12 +76,42 @@ test(Tm1637ModuleTest, flushIncremental) {
         TmModule::kBrightnessCmd | TmModule::kBrightnessLevelOn | 2,
     (int) EventType::kTmi1637StopCondition
   ));
-  assertFalse(tm1637Module.isDigitDirty(4));
+  assertFalse(tm1637Module.isBrightnessDirty());
+  assertEqual(0, tm1637Module.mFlushStage);
+
+  // Iteration 2 has nothing to send, so returns immediately.
+  gEventLog.clear();
+  tm1637Module.flushIncremental();
+  assertEqual(0, gEventLog.getNumRecords());
   assertEqual(0, tm1637Module.mFlushStage);
 
   assertFalse(tm1637Module.isFlushRequired());
 }
 
+test(Tm1637ModuleTest, flushIncremental_wrapsAround) {
+  tmiInterface.begin();
+  tm1637Module.begin();
+
+  // Flushing from begin() sends all 4 digits and the brightness, then stops.
+  gEventLog.clear();
+  for (uint8_t i = 0; i < NUM_DIGITS + 1; ++i) {
+    tm1637Module.flushIncremental();
+  }
+  assertEqual(4 * 7 + 3, gEventLog.getNumRecords());
+  assertFalse(tm1637Module.isFlushRequired());
+
+  // A dirty digit before the current stage is found after wrapping around.
+  tm1637Module.mFlushStage = 3;
+  tm1637Module.setPatternAt(1, 0x11);
+  gEventLog.clear();
+  tm1637Module.flushIncremental();
+  assertEqual(7, gEventLog.getNumRecords());
+  assertEqual(2, tm1637Module.mFlushStage);
+  assertFalse(tm1637Module.isFlushRequired());
+
+  tm1637Module.end();
+}
+
 test(Tm1637ModuleTest, flush) {
   tmiInterface.begin();
   tm1637Module.begin();
@@ -161,6 +166,280 @@ test(Tm1637ModuleTest, flush) {
   tm1637Module.end();
 }
 
+test(Tm1637ModuleTest, flushBurst) {
+  tmiInterface.begin();
+  tm1637Module.begin();
+  tm1637Module.clearDigitsDirty();
+  tm1637Module.clearBrightnessDirty();
+
+  // Nothing dirty, nothing sent.
+  gEventLog.clear();
+  tm1637Module.flushBurst();
+  assertEqual(0, gEventLog.getNumRecords());
+
+  // A single dirty digit is cheaper as a run: cost of 14, vs 26 for flush().
+  tm1637Module.setPatternAt(2, 0x22);
+  gEventLog.clear();
+  tm1637Module.flushBurst();
+  assertEqual(7, gEventLog.getNumRecords());
+  assertTrue(gEventLog.assertEvents(
+    7,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModule::kDataCmdAutoAddress,
+    (int) EventType::kTmi1637StopCondition,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModule::kAddressCmd | 0x2,
+    (int) EventType::kTmi1637SendByte, 0x22,
+    (int) EventType::kTmi1637StopCondition
+  ));
+  assertFalse(tm1637Module.isFlushRequired());
+
+  // Two separate runs cost 23, still cheaper than flush().
+  tm1637Module.setPatternAt(0, 0x00);
+  tm1637Module.setPatternAt(3, 0x33);
+  gEventLog.clear();
+  tm1637Module.flushBurst();
+  assertEqual(11, gEventLog.getNumRecords());
+  assertFalse(tm1637Module.isFlushRequired());
+
+  // Three digits in two runs cost 27, more than flush(), so flush() is used,
+  // which also sends the brightness.
+  tm1637Module.setPatternAt(0, 0x00);
+  tm1637Module.setPatternAt(1, 0x11);
+  tm1637Module.setPatternAt(3, 0x33);
+  gEventLog.clear();
+  tm1637Module.flushBurst();
+  assertEqual(13, gEventLog.getNumRecords());
+  assertFalse(tm1637Module.isFlushRequired());
+
+  tm1637Module.end();
+}
+
+test(Tm1637ModuleTest, flushBurst_brightness) {
+  tmiInterface.begin();
+  tm1637Module.begin();
+  tm1637Module.clearDigitsDirty();
+  tm1637Module.clearBrightnessDirty();
+
+  // Nothing dirty, nothing sent.
+  gEventLog.clear();
+  tm1637Module.flushBurst();
+  assertEqual(0, gEventLog.getNumRecords());
+
+  // Only the brightness is dirty, so only the brightness is sent.
+  tm1637Module.setBrightness(2);
+  gEventLog.clear();
+  tm1637Module.flushBurst();
+  assertTrue(gEventLog.assertEvents(
+    3,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte,
+        TmModule::kBrightnessCmd | TmModule::kBrightnessLevelOn | 2,
+    (int) EventType::kTmi1637StopCondition
+  ));
+
+  // Adjacent dirty digits are sent as a single run.
+  tm1637Module.setPatternAt(1, 0x11);
+  tm1637Module.setPatternAt(2, 0x22);
+  gEventLog.clear();
+  tm1637Module.flushBurst();
+  assertTrue(gEventLog.assertEvents(
+    8,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModule::kDataCmdAutoAddress,
+    (int) EventType::kTmi1637StopCondition,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModule::kAddressCmd | 0x1,
+    (int) EventType::kTmi1637SendByte, 0x11,
+    (int) EventType::kTmi1637SendByte, 0x22,
+    (int) EventType::kTmi1637StopCondition
+  ));
+
+  // All digits dirty is a full flush().
+  for (uint8_t i = 0; i < NUM_DIGITS; ++i) tm1637Module.setPatternAt(i, i);
+  gEventLog.clear();
+  tm1637Module.flushBurst();
+  assertEqual(13, gEventLog.getNumRecords());
+  assertFalse(tm1637Module.isFlushRequired());
+
+  tm1637Module.end();
+}
+
+const uint8_t NUM_DIGITS_6 = 6;
+using TmModule6 = Tm1637Module<TestableTmi1637Interface, NUM_DIGITS_6>;
+TmModule6 tm1637Module6(tmiInterface, ace_segment::kDigitRemapArray6Tm1637);
+
+test(Tm1637ModuleTest, flushBurst_remap) {
+  tmiInterface.begin();
+  tm1637Module6.begin();
+  tm1637Module6.clearDigitsDirty();
+  tm1637Module6.clearBrightnessDirty();
+
+  // Logical digits 0 and 1 are at chip positions 2 and 1, so they form a
+  // single run starting at chip position 1.
+  tm1637Module6.setPatternAt(0, 0x00);
+  tm1637Module6.setPatternAt(1, 0x11);
+  tm1637Module6.setBrightness(3);
+  gEventLog.clear();
+  tm1637Module6.flushBurst();
+  assertEqual(11, gEventLog.getNumRecords());
+  assertTrue(gEventLog.assertEvents(
+    11,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModule6::kDataCmdAutoAddress,
+    (int) EventType::kTmi1637StopCondition,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TmModule6::kAddressCmd | 0x1,
+    (int) EventType::kTmi1637SendByte, 0x11,
+    (int) EventType::kTmi1637SendByte, 0x00,
+    (int) EventType::kTmi1637StopCondition,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte,
+        TmModule6::kBrightnessCmd | TmModule6::kBrightnessLevelOn | 3,
+    (int) EventType::kTmi1637StopCondition
+  ));
+  assertFalse(tm1637Module6.isFlushRequired());
+
+  tm1637Module6.end();
+}
+
+// The compile-time remap sends the digits to the same chip positions as the
+// runtime remap array, without storing a pointer to the array.
+using TmModule6Seq = Tm1637Module<
+    TestableTmi1637Interface,
+    NUM_DIGITS_6,
+    ace_segment::ClockInterface,
+    ace_segment::DigitRemap6Tm1637>;
+TmModule6Seq tm1637Module6Seq(tmiInterface);
+
+test(Tm1637ModuleTest, remapSequence) {
+  assertLess(sizeof(TmModule6Seq), sizeof(TmModule6));
+
+  tmiInterface.begin();
+  tm1637Module6Seq.begin();
+  tm1637Module6Seq.flush();
+
+  // Logical digit 0 is at chip position 2.
+  tm1637Module6Seq.setPatternAt(0, 0x11);
+  gEventLog.clear();
+  tm1637Module6Seq.flushIncremental();
+  assertTrue(gEventLog.assertEvents(
+    7,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, 0b01000100, // kDataCmdFixedAddress
+    (int) EventType::kTmi1637StopCondition,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, 0b11000000 | 2, // kAddressCmd | 2
+    (int) EventType::kTmi1637SendByte, 0x11,
+    (int) EventType::kTmi1637StopCondition
+  ));
+  assertFalse(tm1637Module6Seq.isFlushRequired());
+
+  tm1637Module6Seq.end();
+}
+
+// The 4-digit and 6-digit modules on the same interface share the flushing
+// code of a single Tm1637ModuleBase, which uses the runtime number of digits.
+using TmModuleBase = ace_segment::Tm1637ModuleBase<
+    TestableTmi1637Interface,
+    ace_segment::ClockInterface,
+    ace_segment::RemapArray>;
+
+test(Tm1637ModuleTest, sharedBase) {
+  TmModuleBase* const modules[] = {&tm1637Module, &tm1637Module6};
+  assertEqual(NUM_DIGITS, modules[0]->getNumDigits());
+  assertEqual(NUM_DIGITS_6, modules[1]->getNumDigits());
+
+  tmiInterface.begin();
+  for (TmModuleBase* module : modules) {
+    module->begin();
+    module->flush();
+  }
+
+  // Logical digit 5 is at chip position 3 of the 6-digit module, which is
+  // beyond the last chip position of the 4-digit module.
+  modules[1]->setPatternAt(5, 0x55);
+  gEventLog.clear();
+  modules[1]->flushIncremental();
+  assertTrue(gEventLog.assertEvents(
+    7,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, 0b01000100, // kDataCmdFixedAddress
+    (int) EventType::kTmi1637StopCondition,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, 0b11000000 | 3, // kAddressCmd | 3
+    (int) EventType::kTmi1637SendByte, 0x55,
+    (int) EventType::kTmi1637StopCondition
+  ));
+  assertFalse(modules[1]->isFlushRequired());
+  assertFalse(modules[0]->isFlushRequired());
+
+  for (TmModuleBase* module : modules) {
+    module->end();
+  }
+}
+
+test(Tm1637ModuleTest, step) {
+  tmiInterface.begin();
+  tm1637Module.begin();
+  assertFalse(tm1637Module.step(3));
+
+  tm1637Module.setPatternAt(0, 0x10);
+  tm1637Module.setPatternAt(3, 0x13);
+  tm1637Module.setBrightness(2);
+  tm1637Module.startFlush();
+  assertFalse(tm1637Module.isFlushRequired());
+
+  // The data command, then a run with the first digit fills 3 bytes.
+  gEventLog.clear();
+  assertTrue(tm1637Module.step(3));
+  assertTrue(gEventLog.assertEvents(
+    7,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, 0b01000000, // kDataCmdAutoAddress
+    (int) EventType::kTmi1637StopCondition,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, 0b11000000, // kAddressCmd | 0
+    (int) EventType::kTmi1637SendByte, 0x10,
+    (int) EventType::kTmi1637StopCondition
+  ));
+
+  // The next run of digits resumes at chip position 1.
+  gEventLog.clear();
+  assertTrue(tm1637Module.step(3));
+  assertTrue(gEventLog.assertEvents(
+    5,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, 0b11000001, // kAddressCmd | 1
+    (int) EventType::kTmi1637SendByte, 0x00,
+    (int) EventType::kTmi1637SendByte, 0x00,
+    (int) EventType::kTmi1637StopCondition
+  ));
+
+  // The last digit and the brightness.
+  gEventLog.clear();
+  assertFalse(tm1637Module.step(3));
+  assertTrue(gEventLog.assertEvents(
+    7,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, 0b11000011, // kAddressCmd | 3
+    (int) EventType::kTmi1637SendByte, 0x13,
+    (int) EventType::kTmi1637StopCondition,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, 0b10001010, // kBrightnessCmd | on | 2
+    (int) EventType::kTmi1637StopCondition
+  ));
+
+  // A digit changed during the flush is flushed again later.
+  tm1637Module.startFlush();
+  tm1637Module.step(1);
+  tm1637Module.setPatternAt(0, 0x20);
+  while (tm1637Module.step(1)) {}
+  assertTrue(tm1637Module.isFlushRequired());
+
+  tm1637Module.end();
+}
+
 test(Tm1637ModuleTest, isFlushRequired) {
   tm1637Module.begin();
   assertTrue(tm1637Module.isFlushRequired());
@@ -180,6 +459,83 @@ test(Tm1637ModuleTest, isFlushRequired) {
   tm1637Module.end();
 }
 
+test(Tm1637ModuleTest, getMicrosUntilNextFlush) {
+  tm1637Module.begin();
+  assertEqual((uint32_t) 0, tm1637Module.getMicrosUntilNextFlush());
+
+  // No deadline once all stages are flushed.
+  while (tm1637Module.isFlushRequired()) {
+    tm1637Module.flushIncremental();
+  }
+  assertEqual(ace_segment::kMicrosNoDeadline,
+      tm1637Module.getMicrosUntilNextFlush());
+
+  tm1637Module.setPatternAt(2, 0x22);
+  assertEqual((uint32_t) 0, tm1637Module.getMicrosUntilNextFlush());
+
+  tm1637Module.end();
+}
+
+// A clock that advances 10 micros for every event written to gEventLog,
+// simulating the time spent sending bytes over the wire.
+class EventLogClockInterface {
+  public:
+    static unsigned long micros() { return gEventLog.getNumRecords() * 10; }
+    static unsigned long millis() { return 0; }
+};
+
+using TimedTmModule = Tm1637Module<
+    TestableTmi1637Interface, NUM_DIGITS, EventLogClockInterface>;
+TimedTmModule timedModule(tmiInterface);
+
+test(Tm1637ModuleTest, flushFor) {
+  tmiInterface.begin();
+  timedModule.begin();
+  timedModule.clearDigitsDirty();
+  timedModule.clearBrightnessDirty();
+  assertFalse(timedModule.flushFor(1000));
+
+  timedModule.setPatternAt(1, 0x11);
+  timedModule.setPatternAt(2, 0x22);
+  timedModule.setBrightness(2);
+
+  // Each digit costs 7 events (70 micros), so only digit 1 fits in 100 micros.
+  gEventLog.clear();
+  assertTrue(timedModule.flushFor(100));
+  assertEqual(7, gEventLog.getNumRecords());
+  assertFalse(timedModule.isDigitDirty(1));
+  assertTrue(timedModule.isDigitDirty(2));
+  assertEqual(2, timedModule.mFlushStage);
+
+  // A large budget sends the remaining digit and the brightness.
+  gEventLog.clear();
+  assertFalse(timedModule.flushFor(1000));
+  assertEqual(10, gEventLog.getNumRecords());
+  assertTrue(gEventLog.assertEvents(
+    10,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TimedTmModule::kDataCmdFixedAddress,
+    (int) EventType::kTmi1637StopCondition,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte, TimedTmModule::kAddressCmd | 0x2,
+    (int) EventType::kTmi1637SendByte, 0x22,
+    (int) EventType::kTmi1637StopCondition,
+    (int) EventType::kTmi1637StartCondition,
+    (int) EventType::kTmi1637SendByte,
+        TimedTmModule::kBrightnessCmd | TimedTmModule::kBrightnessLevelOn | 2,
+    (int) EventType::kTmi1637StopCondition
+  ));
+  assertFalse(timedModule.isFlushRequired());
+
+  // A budget of 0 still makes progress, one stage at a time.
+  timedModule.setPatternAt(3, 0x33);
+  gEventLog.clear();
+  while (timedModule.flushFor(0)) {}
+  assertEqual(7, gEventLog.getNumRecords());
+
+  timedModule.end();
+}
+
 //----------------------------------------------------------------------------
 
 void setup() {
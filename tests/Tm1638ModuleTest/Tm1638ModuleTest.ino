@@ -17,6 +17,7 @@ using ace_segment::testing::TestableTmi1638Interface;
 using ace_segment::testing::EventType;
 using ace_segment::testing::gEventLog;
 using ace_segment::Tm1638Module;
+using ace_segment::Tm1638ExtendedModule;
 
 //----------------------------------------------------------------------------
 
@@ -115,6 +116,139 @@ test(Tm1638ModuleTest, isFlushRequired) {
   tm1638Module.end();
 }
 
+test(Tm1638ModuleTest, flushIncremental) {
+  tm1638Module.begin();
+  tm1638Module.flush();
+  assertFalse(tm1638Module.isFlushRequired());
+
+  // Only digit 3 and the brightness are dirty.
+  tm1638Module.setPatternAt(3, 0x33);
+  tm1638Module.setBrightness(2);
+
+  // First call skips the clean digits and sends digit 3 using a fixed address.
+  gEventLog.clear();
+  tm1638Module.flushIncremental();
+  assertTrue(gEventLog.assertEvents(
+    7,
+    (int) EventType::kTmi1638BeginTransaction,
+    (int) EventType::kTmi1638Write, TmModule::kDataCmdFixedAddress,
+    (int) EventType::kTmi1638EndTransaction,
+    (int) EventType::kTmi1638BeginTransaction,
+    (int) EventType::kTmi1638Write, TmModule::kAddressCmd | 6,
+    (int) EventType::kTmi1638Write, 0x33,
+    (int) EventType::kTmi1638EndTransaction
+  ));
+
+  // Second call sends the brightness.
+  gEventLog.clear();
+  tm1638Module.flushIncremental();
+  assertTrue(gEventLog.assertEvents(
+    3,
+    (int) EventType::kTmi1638BeginTransaction,
+    (int) EventType::kTmi1638Write, (
+        TmModule::kBrightnessCmd | TmModule::kBrightnessLevelOn | 2
+    ),
+    (int) EventType::kTmi1638EndTransaction
+  ));
+  assertFalse(tm1638Module.isFlushRequired());
+
+  // Nothing left to send.
+  gEventLog.clear();
+  tm1638Module.flushIncremental();
+  assertEqual(0, gEventLog.getNumRecords());
+
+  tm1638Module.end();
+}
+
+test(Tm1638ModuleTest, step) {
+  tm1638Module.begin();
+  assertFalse(tm1638Module.step(5));
+
+  tm1638Module.setPatternAt(0, 0x10);
+  tm1638Module.setBrightness(2);
+  tm1638Module.startFlush();
+  assertFalse(tm1638Module.isFlushRequired());
+
+  // The data command, then a run with 1 digit of 2 bytes fills 4 bytes, and
+  // the next digit would exceed the budget of 5 bytes.
+  gEventLog.clear();
+  assertTrue(tm1638Module.step(5));
+  assertTrue(gEventLog.assertEvents(
+    8,
+    (int) EventType::kTmi1638BeginTransaction,
+    (int) EventType::kTmi1638Write, TmModule::kDataCmdAutoAddress,
+    (int) EventType::kTmi1638EndTransaction,
+    (int) EventType::kTmi1638BeginTransaction,
+    (int) EventType::kTmi1638Write, TmModule::kAddressCmd,
+    (int) EventType::kTmi1638Write, 0x10,
+    (int) EventType::kTmi1638Write, 0x00,
+    (int) EventType::kTmi1638EndTransaction
+  ));
+
+  // Each following run of 5 bytes resumes with 2 more digits.
+  uint8_t numSteps = 0;
+  do {
+    numSteps++;
+  } while (tm1638Module.step(5));
+  assertEqual(4, numSteps); // 7 digits, then the brightness
+
+  tm1638Module.end();
+}
+
+//----------------------------------------------------------------------------
+// Tm1638ExtendedModule
+//----------------------------------------------------------------------------
+
+// Use 4 digits to keep the number of events under kMaxRecords.
+const uint8_t NUM_EXTENDED_DIGITS = 4;
+using TmExtendedModule =
+    Tm1638ExtendedModule<TestableTmi1638Interface, NUM_EXTENDED_DIGITS>;
+TmExtendedModule tm1638ExtendedModule(tmiInterface);
+
+test(Tm1638ExtendedModuleTest, flush) {
+  tm1638ExtendedModule.begin();
+
+  tm1638ExtendedModule.setPattern16At(1, 0x0111);
+  tm1638ExtendedModule.setPattern16At(2, 0xFF22); // upper bits are ignored
+  assertEqual(0x0111, tm1638ExtendedModule.getPattern16At(1));
+  assertEqual(0x0322, tm1638ExtendedModule.getPattern16At(2));
+  assertEqual(0x22, tm1638ExtendedModule.getPatternAt(2));
+  tm1638ExtendedModule.setBrightness(2);
+
+  // Both bytes of each digit are sent.
+  gEventLog.clear();
+  tm1638ExtendedModule.flush();
+  assertTrue(gEventLog.assertEvents(
+    17,
+    (int) EventType::kTmi1638BeginTransaction,
+    (int) EventType::kTmi1638Write, TmModule::kDataCmdAutoAddress,
+    (int) EventType::kTmi1638EndTransaction,
+
+    (int) EventType::kTmi1638BeginTransaction,
+    (int) EventType::kTmi1638Write, TmModule::kAddressCmd,
+    (int) EventType::kTmi1638Write, 0x00, // seg0
+    (int) EventType::kTmi1638Write, 0x00, // seg0
+    (int) EventType::kTmi1638Write, 0x11, // seg1
+    (int) EventType::kTmi1638Write, 0x01, // seg1
+    (int) EventType::kTmi1638Write, 0x22, // seg2
+    (int) EventType::kTmi1638Write, 0x03, // seg2
+    (int) EventType::kTmi1638Write, 0x00, // seg3
+    (int) EventType::kTmi1638Write, 0x00, // seg3
+    (int) EventType::kTmi1638EndTransaction,
+
+    (int) EventType::kTmi1638BeginTransaction,
+    (int) EventType::kTmi1638Write, (
+        TmModule::kBrightnessCmd
+        | TmModule::kBrightnessLevelOn
+        | 2
+    ),
+    (int) EventType::kTmi1638EndTransaction
+  ));
+  assertFalse(tm1638ExtendedModule.isFlushRequired());
+
+  tm1638ExtendedModule.end();
+}
+
 //----------------------------------------------------------------------------
 
 void setup() {
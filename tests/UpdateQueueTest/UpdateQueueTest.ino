@@ -0,0 +1,173 @@
+#line 2 "UpdateQueueTest.ino"
+
+/*
+ * MIT License
+ * Copyright (c) 2026 Brian T. Park
+ */
+
+#include <Arduino.h>
+#include <AUnitVerbose.h>
+#include <AceSegment.h>
+#include <ace_segment/testing/TestableLedModule.h>
+#if defined(EPOXY_DUINO)
+  #include <thread>
+#endif
+
+using aunit::TestRunner;
+using ace_segment::UpdateQueue;
+using ace_segment::testing::TestableLedModule;
+
+//----------------------------------------------------------------------------
+
+const uint8_t NUM_DIGITS = 4;
+TestableLedModule<NUM_DIGITS> ledModule;
+
+test(UpdateQueueTest, apply) {
+  UpdateQueue<8> queue;
+  ledModule.begin();
+  assertTrue(queue.isEmpty());
+
+  assertTrue(queue.setPatternAt(1, 0x11));
+  assertTrue(queue.setBrightness(3));
+  const uint8_t patterns[] = {0x22, 0x33};
+  assertTrue(queue.setPatterns(2, patterns, 2));
+  assertFalse(queue.isEmpty());
+
+  // Nothing reaches the module until apply().
+  assertEqual(0, ledModule.getPatternAt(1));
+  assertEqual(4, queue.apply(ledModule));
+  assertTrue(queue.isEmpty());
+  assertEqual(0x11, ledModule.getPatternAt(1));
+  assertEqual(0x22, ledModule.getPatternAt(2));
+  assertEqual(0x33, ledModule.getPatternAt(3));
+  assertEqual(3, ledModule.getBrightness());
+
+  // Nothing left to apply.
+  assertEqual(0, queue.apply(ledModule));
+}
+
+test(UpdateQueueTest, full) {
+  UpdateQueue<4> queue;
+  ledModule.begin();
+
+  assertTrue(queue.setPatternAt(0, 0x01));
+  assertTrue(queue.setPatternAt(1, 0x02));
+  assertTrue(queue.setPatternAt(2, 0x03));
+
+  // A bulk update which does not fit is rejected as a whole.
+  const uint8_t patterns[] = {0x44, 0x55};
+  assertFalse(queue.setPatterns(2, patterns, 2));
+  assertTrue(queue.setBrightness(2));
+  assertFalse(queue.setPatternAt(3, 0x04));
+
+  assertEqual(4, queue.apply(ledModule));
+  assertEqual(0x03, ledModule.getPatternAt(2));
+  assertEqual(2, ledModule.getBrightness());
+  assertTrue(queue.setPatterns(2, patterns, 2));
+}
+
+test(UpdateQueueTest, wrapAround) {
+  UpdateQueue<4> queue;
+  ledModule.begin();
+
+  // The free-running 8-bit indexes overflow many times.
+  for (uint16_t i = 0; i < 1000; ++i) {
+    assertTrue(queue.setPatternAt(i % NUM_DIGITS, (uint8_t) i));
+    assertTrue(queue.setPatternAt((i + 1) % NUM_DIGITS, (uint8_t) ~i));
+    assertTrue(queue.setBrightness((uint8_t) i));
+    assertEqual(3, queue.apply(ledModule));
+    assertEqual((uint8_t) i, ledModule.getPatternAt(i % NUM_DIGITS));
+    assertEqual((uint8_t) ~i, ledModule.getPatternAt((i + 1) % NUM_DIGITS));
+    assertEqual((uint8_t) i, ledModule.getBrightness());
+  }
+}
+
+//----------------------------------------------------------------------------
+// Stress test using a real producer thread, only on EpoxyDuino.
+//----------------------------------------------------------------------------
+
+#if defined(EPOXY_DUINO)
+
+/**
+ * Verifies that the commands arrive complete and in order. The producer sends
+ * update `i` as a bulk write of all digits set to `(uint8_t) i`, and every
+ * kBrightnessInterval updates it also sends the brightness.
+ */
+struct CheckingModule {
+  static const uint32_t kBrightnessInterval = 64;
+
+  void setPatternAt(uint8_t pos, uint8_t pattern) {
+    if (pos != numPatterns % NUM_DIGITS) numErrors++;
+    if (pattern != (uint8_t) (numPatterns / NUM_DIGITS)) numErrors++;
+    numPatterns++;
+  }
+
+  void setBrightness(uint8_t brightness) {
+    // Sent right after the bulk write of update `i`.
+    uint32_t i = numPatterns / NUM_DIGITS - 1;
+    if (i % kBrightnessInterval != 0) numErrors++;
+    if (brightness != (uint8_t) (i / kBrightnessInterval)) numErrors++;
+    numBrightnesses++;
+  }
+
+  uint32_t numPatterns = 0;
+  uint32_t numBrightnesses = 0;
+  uint32_t numErrors = 0;
+};
+
+test(UpdateQueueTest, stress) {
+  const uint32_t NUM_UPDATES = 200000;
+  UpdateQueue<16> queue;
+  CheckingModule module;
+
+  std::thread producer([&queue]() {
+    uint8_t patterns[NUM_DIGITS];
+    for (uint32_t i = 0; i < NUM_UPDATES; ++i) {
+      memset(patterns, (uint8_t) i, NUM_DIGITS);
+      while (! queue.setPatterns(0, patterns, NUM_DIGITS)) {
+        std::this_thread::yield();
+      }
+      if (i % CheckingModule::kBrightnessInterval == 0) {
+        uint8_t brightness = i / CheckingModule::kBrightnessInterval;
+        while (! queue.setBrightness(brightness)) {
+          std::this_thread::yield();
+        }
+      }
+    }
+  });
+
+  // Each apply() must see whole bulk writes only.
+  uint32_t numTornUpdates = 0;
+  while (module.numPatterns < NUM_UPDATES * NUM_DIGITS) {
+    if (queue.apply(module) == 0) std::this_thread::yield();
+    if (module.numPatterns % NUM_DIGITS != 0) numTornUpdates++;
+  }
+  producer.join();
+  queue.apply(module);
+
+  assertEqual((uint32_t) 0, module.numErrors);
+  assertEqual((uint32_t) 0, numTornUpdates);
+  assertEqual(NUM_UPDATES * NUM_DIGITS, module.numPatterns);
+  assertEqual(
+      (NUM_UPDATES + CheckingModule::kBrightnessInterval - 1)
+          / CheckingModule::kBrightnessInterval,
+      module.numBrightnesses);
+  assertTrue(queue.isEmpty());
+}
+
+#endif
+
+//----------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // Wait for stability on some boards, otherwise garage on Serial
+#endif
+
+  Serial.begin(115200); // ESP8266 default of 74880 not supported on Linux
+  while (!Serial); // Wait until Serial is ready - Leonardo/Micro
+}
+
+void loop() {
+  TestRunner::run();
+}